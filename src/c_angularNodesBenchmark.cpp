@@ -0,0 +1,495 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+//-----------------------------------------------------------------------------
+//  angularNodesBenchmark command
+//
+//  Times the angular nodes against equivalent networks of stock math nodes
+//  and the unitConversion nodes Maya inserts around them.
+//
+//  For each node type, a rig is built with a single animated driver and
+//  -nodeCount units that each read the driver's rotateX and write the rotateX
+//  of their own transform. The angular rig uses one angular node per unit, the
+//  baseline rig uses a stock math node wrapped in unitConversion nodes. Each
+//  rig is played over -frames frames in every evaluation mode (DG, and the
+//  Evaluation Manager's serial and parallel modes where available) and then
+//  deleted. Each rig is built in a new namespace, so that deleting it never
+//  touches the rest of the scene.
+//
+//  The report is a JSON document that is returned as the command result, or
+//  written to -file when it is given. For each rig it reports the units 
+//  evaluated per second, which compares the two variants like for like, and 
+//  the nodes evaluated per second, which counts every node in the rig 
+//  including the unitConversion nodes of the baseline.
+//
+//  The angleSpring baseline is an expression that integrates the same damped
+//  spring with 10 substeps per frame, which matches the node's defaults at 24
+//  fps. The anglePoseInterpolator baseline drives three poses, each through a
+//  remapValue node with a triangular falloff and a clamp node, and sums their
+//  weights; the angular rig sums the three output weights the same way.
+//  angleCache is not benchmarked, as it replays baked values and has no stock
+//  equivalent. Types without a rig are skipped with a warning.
+//
+//  Flags
+//      -nodeCount  (-nc)   Number of units in each rig. Default is 100.
+//      -frames     (-fr)   Number of frames to time. Default is 100.
+//      -nodeType   (-nt)   Node type to benchmark; multi-use. Default is all.
+//      -file       (-f)    Path of the file to write the report to.
+//-----------------------------------------------------------------------------
+
+#include "c_angularNodesBenchmark.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <maya/MAnimControl.h>
+#include <maya/MArgDatabase.h>
+#include <maya/MArgList.h>
+#include <maya/MGlobal.h>
+#include <maya/MPlug.h>
+#include <maya/MPlugArray.h>
+#include <maya/MPxCommand.h>
+#include <maya/MSelectionList.h>
+#include <maya/MString.h>
+#include <maya/MStringArray.h>
+#include <maya/MSyntax.h>
+#include <maya/MTime.h>
+#include <maya/MTimer.h>
+
+#define NODE_COUNT_FLAG         "-nc"
+#define NODE_COUNT_LONG_FLAG    "-nodeCount"
+#define FRAMES_FLAG             "-fr"
+#define FRAMES_LONG_FLAG        "-frames"
+#define NODE_TYPE_FLAG          "-nt"
+#define NODE_TYPE_LONG_FLAG     "-nodeType"
+#define FILE_FLAG               "-f"
+#define FILE_LONG_FLAG          "-file"
+
+const char* BENCHMARK_NAMESPACE = "angularNodesBenchmark";
+
+// MEL bodies for a single unit of each rig. Each body reads the angle plug
+// named by $in and writes the angle plug named by $out.
+struct BenchmarkRig
+{
+    const char* nodeType;
+    const char* angularUnit;
+    const char* baselineUnit;
+};
+
+const BenchmarkRig BENCHMARK_RIGS[] = {
+    {
+        "angleBinaryOp",
+        "string $n = `createNode angleBinaryOp`; setAttr ($n + \".operation\") 1; setAttr ($n + \".input2\") 10;"
+        "connectAttr $in ($n + \".input1\"); connectAttr ($n + \".output\") $out;",
+        "string $n = `createNode addDoubleLinear`; setAttr ($n + \".input2\") 10;"
+        "connectAttr $in ($n + \".input1\"); connectAttr ($n + \".output\") $out;"
+    },
+    {
+        "angleBlend",
+        "string $n = `createNode angleBlend`; setAttr ($n + \".input[1]\") 30; setAttr ($n + \".weight[0]\") 0.5; setAttr ($n + \".weight[1]\") 0.5;"
+        "connectAttr $in ($n + \".input[0]\"); connectAttr ($n + \".output\") $out;",
+        "string $n = `createNode blendWeighted`; setAttr ($n + \".input[1]\") 30; setAttr ($n + \".weight[0]\") 0.5; setAttr ($n + \".weight[1]\") 0.5;"
+        "connectAttr $in ($n + \".input[0]\"); connectAttr ($n + \".output\") $out;"
+    },
+    {
+        "angleMultiOp",
+        "string $n = `createNode angleMultiOp`; setAttr ($n + \".operation\") 1; setAttr ($n + \".input[1]\") 10;"
+        "connectAttr $in ($n + \".input[0]\"); connectAttr ($n + \".output\") $out;",
+        "string $n = `createNode plusMinusAverage`; setAttr ($n + \".operation\") 1; setAttr ($n + \".input1D[1]\") 10;"
+        "connectAttr $in ($n + \".input1D[0]\"); connectAttr ($n + \".output1D\") $out;"
+    },
+    {
+        "angleScalarOp",
+        "string $n = `createNode angleScalarOp`; setAttr ($n + \".operation\") 3; setAttr ($n + \".scalar\") 0.5;"
+        "connectAttr $in ($n + \".input\"); connectAttr ($n + \".output\") $out;",
+        "string $n = `createNode multDoubleLinear`; setAttr ($n + \".input2\") 0.5;"
+        "connectAttr $in ($n + \".input1\"); connectAttr ($n + \".output\") $out;"
+    },
+    {
+        "angleSegmentOp",
+        "string $n = `createNode angleSegmentOp`; setAttr ($n + \".operation\") 1; setAttr ($n + \".input[1]\") 10; setAttr ($n + \".segmentOffset[0]\") 0;"
+        "connectAttr $in ($n + \".input[0]\"); connectAttr ($n + \".output[0]\") $out;",
+        "string $n = `createNode plusMinusAverage`; setAttr ($n + \".operation\") 1; setAttr ($n + \".input1D[1]\") 10;"
+        "connectAttr $in ($n + \".input1D[0]\"); connectAttr ($n + \".output1D\") $out;"
+    },
+    {
+        "anglePoseInterpolator",
+        "string $n = `createNode anglePoseInterpolator`; setAttr ($n + \".radius\") 90;"
+        "setAttr ($n + \".pose[0].poseInput[0]\") -90; setAttr ($n + \".pose[1].poseInput[0]\") 0; setAttr ($n + \".pose[2].poseInput[0]\") 90;"
+        "string $sum = `createNode plusMinusAverage`; connectAttr $in ($n + \".input[0]\");"
+        "for ($p = 0; $p < 3; $p++) connectAttr ($n + \".outputWeight[\" + $p + \"]\") ($sum + \".input1D[\" + $p + \"]\");"
+        "connectAttr ($sum + \".output1D\") $out;",
+        "string $sum = `createNode plusMinusAverage`;"
+        "for ($p = 0; $p < 3; $p++) {"
+        "string $r = `createNode remapValue`; setAttr ($r + \".inputMin\") ($p * 90 - 180); setAttr ($r + \".inputMax\") ($p * 90);"
+        "setAttr ($r + \".value[0].value_Position\") 0; setAttr ($r + \".value[0].value_FloatValue\") 0;"
+        "setAttr ($r + \".value[1].value_Position\") 0.5; setAttr ($r + \".value[1].value_FloatValue\") 1;"
+        "setAttr ($r + \".value[2].value_Position\") 1; setAttr ($r + \".value[2].value_FloatValue\") 0;"
+        "string $c = `createNode clamp`; setAttr ($c + \".maxR\") 1;"
+        "connectAttr $in ($r + \".inputValue\"); connectAttr ($r + \".outValue\") ($c + \".inputR\");"
+        "connectAttr ($c + \".outputR\") ($sum + \".input1D[\" + $p + \"]\"); }"
+        "connectAttr ($sum + \".output1D\") $out;"
+    },
+    {
+        "angleSpring",
+        "string $n = `createNode angleSpring`; connectAttr time1.outTime ($n + \".time\");"
+        "connectAttr $in ($n + \".target\"); connectAttr ($n + \".output\") $out;",
+        "addAttr -ln \"springPosition\" -at double $s; addAttr -ln \"springVelocity\" -at double $s;"
+        "expression -s (\"float $x = `getAttr \" + $s + \".springPosition`; float $v = `getAttr \" + $s + \".springVelocity`;\""
+        "+ \"if (frame <= 1) { $x = \" + $in + \"; $v = 0; } else {\""
+        "+ \"float $h = 1.0 / 240.0; float $k = 100.0; float $c = 20.0;\""
+        "+ \"for ($j = 0; $j < 10; $j++) { $v = ($v + $h * $k * (\" + $in + \" - $x)) / (1.0 + $h * $c + $h * $h * $k); $x += $h * $v; } }\""
+        "+ \"setAttr \" + $s + \".springPosition $x; setAttr \" + $s + \".springVelocity $v; \" + $out + \" = $x;\");"
+    },
+    {
+        "angleUnaryOp",
+        "string $n = `createNode angleUnaryOp`; setAttr ($n + \".operation\") 2;"
+        "connectAttr $in ($n + \".input\"); connectAttr ($n + \".output\") $out;",
+        "string $n = `createNode multDoubleLinear`; setAttr ($n + \".input2\") -1;"
+        "connectAttr $in ($n + \".input1\"); connectAttr ($n + \".output\") $out;"
+    },
+    {
+        "clampAngle",
+        "string $n = `createNode clampAngle`; setAttr ($n + \".min\") -45; setAttr ($n + \".max\") 45;"
+        "connectAttr $in ($n + \".input\"); connectAttr ($n + \".output\") $out;",
+        "string $n = `createNode clamp`; setAttr ($n + \".minR\") -45; setAttr ($n + \".maxR\") 45;"
+        "connectAttr $in ($n + \".inputR\"); connectAttr ($n + \".outputR\") $out;"
+    }
+};
+
+const unsigned NUM_BENCHMARK_RIGS = sizeof(BENCHMARK_RIGS) / sizeof(BenchmarkRig);
+
+struct BenchmarkResult
+{
+    std::string nodeType;
+    std::string variant;
+    std::string mode;
+    int         nodes;
+    double      seconds;
+};
+
+void* AngularNodesBenchmarkCommand::creator()
+{
+    return new AngularNodesBenchmarkCommand();
+}
+
+MSyntax AngularNodesBenchmarkCommand::newSyntax()
+{
+    MSyntax syntax;
+
+    syntax.addFlag(NODE_COUNT_FLAG, NODE_COUNT_LONG_FLAG, MSyntax::kUnsigned);
+    syntax.addFlag(FRAMES_FLAG, FRAMES_LONG_FLAG, MSyntax::kUnsigned);
+    syntax.addFlag(NODE_TYPE_FLAG, NODE_TYPE_LONG_FLAG, MSyntax::kString);
+    syntax.makeFlagMultiUse(NODE_TYPE_FLAG);
+    syntax.addFlag(FILE_FLAG, FILE_LONG_FLAG, MSyntax::kString);
+
+    return syntax;
+}
+
+bool AngularNodesBenchmarkCommand::isUndoable() const
+{
+    return false;
+}
+
+// Returns the name of a root namespace that does not exist yet.
+static MString uniqueNamespace()
+{
+    MString name = BENCHMARK_NAMESPACE;
+
+    for (int i = 1; ; i++)
+    {
+        int exists = 0;
+        MGlobal::executeCommand(MString("namespace -exists \":") + name + "\"", exists);
+
+        if (!exists)
+        {
+            return name;
+        }
+
+        name = BENCHMARK_NAMESPACE;
+        name += i;
+    }
+}
+
+static int countNodes()
+{
+    MStringArray nodes;
+    MGlobal::executeCommand("ls -dependencyNodes", nodes);
+
+    return (int) nodes.length();
+}
+
+// Builds one rig inside the benchmark namespace and returns the number of
+// nodes it added besides the driver, its animCurve and the sink transforms.
+static MStatus buildRig(const MString& rigNamespace, const char* unitBody, unsigned nodeCount, unsigned frames, MPlugArray& sinks, int& numNodes)
+{
+    MStatus status;
+
+    int numNodesBefore = countNodes();
+
+    std::ostringstream mel;
+    mel << "{"
+        << "string $d = `createNode transform -n \"driver\"`;"
+        << "setKeyframe -at \"rx\" -t 1 -v 0 $d;"
+        << "setKeyframe -at \"rx\" -t " << frames << " -v 360 $d;"
+        << "for ($i = 0; $i < " << nodeCount << "; $i++) {"
+        << "string $s = `createNode transform -n (\"sink\" + $i)`;"
+        << "string $in = $d + \".rx\";"
+        << "string $out = $s + \".rx\";"
+        << unitBody
+        << "}"
+        << "}";
+
+    status = MGlobal::executeCommand(MString(mel.str().c_str()));
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    numNodes = countNodes() - numNodesBefore - (int) nodeCount - 2;
+
+    MSelectionList selection;
+    sinks.clear();
+
+    for (unsigned i = 0; i < nodeCount; i++)
+    {
+        std::ostringstream name;
+        name << ":" << rigNamespace.asChar() << ":sink" << i << ".rx";
+
+        selection.clear();
+        status = selection.add(MString(name.str().c_str()));
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        MPlug sink;
+        selection.getPlug(0, sink);
+        sinks.append(sink);
+    }
+
+    return MS::kSuccess;
+}
+
+// Plays the rig over the frame range and returns the elapsed wall time. Each
+// sink is read on every frame so that the DG actually pulls the network.
+static double timeRig(const MPlugArray& sinks, unsigned frames)
+{
+    double checksum = 0.0;
+
+    MTimer timer;
+    timer.beginTimer();
+
+    for (unsigned frame = 1; frame <= frames; frame++)
+    {
+        MAnimControl::setCurrentTime(MTime((double) frame, MTime::uiUnit()));
+
+        for (unsigned i = 0; i < sinks.length(); i++)
+        {
+            checksum += sinks[i].asDouble();
+        }
+    }
+
+    timer.endTimer();
+
+    // Keeps the reads from being optimized away.
+    if (checksum != checksum)
+    {
+        MGlobal::displayWarning("angularNodesBenchmark: rig produced NaN values.");
+    }
+
+    return timer.elapsedTime();
+}
+
+static void writeReport(std::ostream& out, const std::vector<BenchmarkResult>& results, unsigned nodeCount, unsigned frames)
+{
+    out << "{\n"
+        << "    \"nodeCount\": " << nodeCount << ",\n"
+        << "    \"frames\": " << frames << ",\n"
+        << "    \"results\": [";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& r = results[i];
+
+        double frameTime = r.seconds / (double) frames;
+        double unitsPerSecond = r.seconds > 0.0 ? (double) nodeCount * frames / r.seconds : 0.0;
+        double nodesPerSecond = r.seconds > 0.0 ? (double) r.nodes * frames / r.seconds : 0.0;
+
+        out << (i == 0 ? "\n" : ",\n")
+            << "        {"
+            << "\"nodeType\": \"" << r.nodeType << "\", "
+            << "\"variant\": \"" << r.variant << "\", "
+            << "\"mode\": \"" << r.mode << "\", "
+            << "\"nodes\": " << r.nodes << ", "
+            << "\"seconds\": " << r.seconds << ", "
+            << "\"frameTimeMs\": " << frameTime * 1000.0 << ", "
+            << "\"unitsPerSecond\": " << unitsPerSecond << ", "
+            << "\"nodesPerSecond\": " << nodesPerSecond
+            << "}";
+    }
+
+    out << "\n    ]\n}\n";
+}
+
+MStatus AngularNodesBenchmarkCommand::doIt(const MArgList& argList)
+{
+    MStatus status;
+
+    MArgDatabase argData(syntax(), argList, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    unsigned nodeCount = 100;
+    unsigned frames = 100;
+    MString filePath;
+    std::vector<std::string> nodeTypes;
+
+    if (argData.isFlagSet(NODE_COUNT_FLAG)) argData.getFlagArgument(NODE_COUNT_FLAG, 0, nodeCount);
+    if (argData.isFlagSet(FRAMES_FLAG)) argData.getFlagArgument(FRAMES_FLAG, 0, frames);
+    if (argData.isFlagSet(FILE_FLAG)) argData.getFlagArgument(FILE_FLAG, 0, filePath);
+
+    for (unsigned i = 0; i < argData.numberOfFlagUses(NODE_TYPE_FLAG); i++)
+    {
+        MArgList flagArgs;
+        argData.getFlagArgumentList(NODE_TYPE_FLAG, i, flagArgs);
+        nodeTypes.push_back(flagArgs.asString(0).asChar());
+    }
+
+    for (size_t t = 0; t < nodeTypes.size(); t++)
+    {
+        bool hasRig = false;
+
+        for (unsigned r = 0; r < NUM_BENCHMARK_RIGS; r++)
+        {
+            hasRig = hasRig || nodeTypes[t] == BENCHMARK_RIGS[r].nodeType;
+        }
+
+        if (!hasRig)
+        {
+            displayWarning(kCOMMAND_NAME + ": there is no benchmark rig for " + nodeTypes[t].c_str() + "; skipping it.");
+        }
+    }
+
+    if (nodeCount == 0 || frames < 2)
+    {
+        displayError(kCOMMAND_NAME + ": -nodeCount must be at least 1 and -frames at least 2.");
+        return MS::kInvalidParameter;
+    }
+
+    std::vector<std::string> modes;
+    modes.push_back("off");
+
+#if MAYA_API_VERSION >= 201600
+    modes.push_back("serial");
+    modes.push_back("parallel");
+
+    MStringArray originalMode;
+    MGlobal::executeCommand("evaluationManager -query -mode", originalMode);
+#endif
+
+    MTime originalTime = MAnimControl::currentTime();
+
+    MString currentNamespace;
+    MGlobal::executeCommand("namespaceInfo -currentNamespace -absoluteName", currentNamespace);
+
+    std::vector<BenchmarkResult> results;
+
+    for (unsigned r = 0; r < NUM_BENCHMARK_RIGS; r++)
+    {
+        const BenchmarkRig& rig = BENCHMARK_RIGS[r];
+
+        bool isRequested = nodeTypes.empty();
+
+        for (size_t t = 0; t < nodeTypes.size(); t++)
+        {
+            isRequested = isRequested || nodeTypes[t] == rig.nodeType;
+        }
+
+        if (!isRequested) continue;
+
+        for (int v = 0; v < 2; v++)
+        {
+            const char* variant = v == 0 ? "angular" : "baseline";
+            const char* unitBody = v == 0 ? rig.angularUnit : rig.baselineUnit;
+
+            MString rigNamespace;
+
+            MGlobal::executeCommand("namespace -set \":\";");
+            status = MGlobal::executeCommand(MString("namespace -add \"") + uniqueNamespace() + "\";", rigNamespace);
+
+            if (!status || rigNamespace.length() == 0)
+            {
+                displayWarning(kCOMMAND_NAME + ": could not create a namespace for the " + variant + " " + rig.nodeType + " rig; skipping it.");
+                continue;
+            }
+
+            // Namespaces below are given as absolute paths from the root.
+            if (rigNamespace.index(':') == 0)
+            {
+                rigNamespace = rigNamespace.substring(1, rigNamespace.length() - 1);
+            }
+
+            MGlobal::executeCommand(MString("namespace -set \":") + rigNamespace + "\";");
+
+            MPlugArray sinks;
+            int numNodes = 0;
+            status = buildRig(rigNamespace, unitBody, nodeCount, frames, sinks, numNodes);
+
+            if (status)
+            {
+                for (size_t m = 0; m < modes.size(); m++)
+                {
+#if MAYA_API_VERSION >= 201600
+                    MGlobal::executeCommand(MString("evaluationManager -mode \"") + modes[m].c_str() + "\";");
+#endif
+                    // Warm up so that the Evaluation Manager graph is built and
+                    // the first-compute costs are not part of the timing.
+                    timeRig(sinks, 2);
+
+                    BenchmarkResult result;
+                    result.nodeType = rig.nodeType;
+                    result.variant = variant;
+                    result.mode = modes[m] == "off" ? "dg" : modes[m];
+                    result.nodes = numNodes;
+                    result.seconds = timeRig(sinks, frames);
+
+                    results.push_back(result);
+                }
+            }
+            else
+            {
+                displayWarning(kCOMMAND_NAME + ": could not build the " + variant + " " + rig.nodeType + " rig; skipping it.");
+            }
+
+            MGlobal::executeCommand(MString("namespace -set \":\"; namespace -removeNamespace \":") + rigNamespace + "\" -deleteNamespaceContent;");
+        }
+    }
+
+#if MAYA_API_VERSION >= 201600
+    if (originalMode.length() > 0)
+    {
+        MGlobal::executeCommand(MString("evaluationManager -mode \"") + originalMode[0] + "\";");
+    }
+#endif
+
+    MGlobal::executeCommand(MString("namespace -set \"") + currentNamespace + "\";");
+    MAnimControl::setCurrentTime(originalTime);
+
+    std::ostringstream report;
+    writeReport(report, results, nodeCount, frames);
+
+    if (filePath.length() > 0)
+    {
+        std::ofstream file(filePath.asChar());
+
+        if (!file)
+        {
+            displayError(kCOMMAND_NAME + ": could not open '" + filePath + "' for writing.");
+            return MS::kFailure;
+        }
+
+        file << report.str();
+    }
+
+    setResult(MString(report.str().c_str()));
+
+    return MS::kSuccess;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef C_ANGULAR_NODES_BENCHMARK_H
+#define C_ANGULAR_NODES_BENCHMARK_H
+
+#include <maya/MArgList.h>
+#include <maya/MPxCommand.h>
+#include <maya/MString.h>
+#include <maya/MSyntax.h>
+
+class AngularNodesBenchmarkCommand : public MPxCommand
+{
+public:
+    virtual MStatus         doIt(const MArgList& argList);
+    virtual bool            isUndoable() const;
+
+    static  void*           creator();
+    static  MSyntax         newSyntax();
+
+public:
+    static MString          kCOMMAND_NAME;
+};
+
+#endif
\ No newline at end of file
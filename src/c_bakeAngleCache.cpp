@@ -0,0 +1,480 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+//-----------------------------------------------------------------------------
+//  bakeAngleCache command
+//
+//  Records the inputs of an angleCache node over a frame range into a cache
+//  file, then points the node at the file and switches it to Cached mode.
+//  The node's time is connected to the scene time if it is not connected.
+//
+//  The input connections are moved into the node's Stashed Input, so that
+//  the upstream network is no longer evaluated while the cache plays back.
+//  With -restore, the stashed connections are made again and the node is
+//  switched back to Live mode. Baking a node that has stashed inputs
+//  restores them first.
+//
+//  Flags
+//      -startFrame (-sf)   First frame to bake. Default is the playback start.
+//      -endFrame   (-ef)   Last frame to bake. Default is the playback end.
+//      -file       (-f)    Path of the cache file. Default is the node's
+//                          cacheFile.
+//      -restore    (-rs)   Restore the stashed inputs instead of baking.
+//      -check      (-ch)   Check the cache instead of baking. The sources of
+//                          the inputs, stashed or connected, are sampled over
+//                          the cached range and compared against the
+//                          checksum of the baked values.
+//
+//  Undo reverts the changes to the node and its connections. The cache file
+//  is kept.
+//
+//  Returns the path of the cache file, or with -check, true if the cache is
+//  stale.
+//-----------------------------------------------------------------------------
+
+#include "c_bakeAngleCache.h"
+#include "n_angleCache.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include <maya/MAnimControl.h>
+#include <maya/MArgDatabase.h>
+#include <maya/MArgList.h>
+#include <maya/MDagPath.h>
+#include <maya/MDGModifier.h>
+#include <maya/MFn.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MIntArray.h>
+#include <maya/MItDependencyNodes.h>
+#include <maya/MObject.h>
+#include <maya/MObjectArray.h>
+#include <maya/MPlug.h>
+#include <maya/MPlugArray.h>
+#include <maya/MPxCommand.h>
+#include <maya/MSelectionList.h>
+#include <maya/MString.h>
+#include <maya/MSyntax.h>
+#include <maya/MTime.h>
+
+#define START_FRAME_FLAG        "-sf"
+#define START_FRAME_LONG_FLAG   "-startFrame"
+#define END_FRAME_FLAG          "-ef"
+#define END_FRAME_LONG_FLAG     "-endFrame"
+#define FILE_FLAG               "-f"
+#define FILE_LONG_FLAG          "-file"
+#define RESTORE_FLAG            "-rs"
+#define RESTORE_LONG_FLAG       "-restore"
+#define CHECK_FLAG              "-ch"
+#define CHECK_LONG_FLAG         "-check"
+
+void* BakeAngleCacheCommand::creator()
+{
+    return new BakeAngleCacheCommand();
+}
+
+MSyntax BakeAngleCacheCommand::newSyntax()
+{
+    MSyntax syntax;
+
+    syntax.addFlag(START_FRAME_FLAG, START_FRAME_LONG_FLAG, MSyntax::kDouble);
+    syntax.addFlag(END_FRAME_FLAG, END_FRAME_LONG_FLAG, MSyntax::kDouble);
+    syntax.addFlag(FILE_FLAG, FILE_LONG_FLAG, MSyntax::kString);
+    syntax.addFlag(RESTORE_FLAG, RESTORE_LONG_FLAG);
+    syntax.addFlag(CHECK_FLAG, CHECK_LONG_FLAG);
+
+    syntax.setObjectType(MSyntax::kSelectionList, 1, 1);
+    syntax.useSelectionAsDefault(true);
+
+    return syntax;
+}
+
+bool BakeAngleCacheCommand::isUndoable() const
+{
+    return true;
+}
+
+MStatus BakeAngleCacheCommand::redoIt()
+{
+    return dgMod_.doIt();
+}
+
+MStatus BakeAngleCacheCommand::undoIt()
+{
+    return dgMod_.undoIt();
+}
+
+// Finds the plug for an attribute path on a node, as stored in Stashed Input.
+static MStatus findSourcePlug(const MObject& node, const MString& attribute, MPlug& plug)
+{
+    MString nodeName;
+
+    if (node.hasFn(MFn::kDagNode))
+    {
+        MDagPath path;
+        MDagPath::getAPathTo(node, path);
+        nodeName = path.partialPathName();
+    }
+    else
+    {
+        nodeName = MFnDependencyNode(node).name();
+    }
+
+    MSelectionList selection;
+    MStatus status = selection.add(nodeName + "." + attribute);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    return selection.getPlug(0, plug);
+}
+
+// Samples each plug at every frame of the cache, channel by channel, and
+// returns to the current time.
+static void sampleChannels(const std::vector<MPlug>& plugs, const AngleCacheHeader& header, std::vector<double>& values)
+{
+    uint32_t frameCount = header.frameCount;
+
+    values.assign(plugs.size() * frameCount, 0.0);
+
+    MTime originalTime = MAnimControl::currentTime();
+
+    for (uint32_t f = 0; f < frameCount; f++)
+    {
+        MAnimControl::setCurrentTime(MTime(header.startSeconds + f * header.frameSeconds, MTime::kSeconds));
+
+        for (size_t c = 0; c < plugs.size(); c++)
+        {
+            values[c * frameCount + f] = plugs[c].asMAngle().asDegrees();
+        }
+    }
+
+    MAnimControl::setCurrentTime(originalTime);
+}
+
+MStatus BakeAngleCacheCommand::restoreInputs(MFnDependencyNode& fnNode)
+{
+    MStatus status;
+
+    MPlug inputPlug = fnNode.findPlug(AngleCacheNode::aInput, true);
+    MPlug stashPlug = fnNode.findPlug(AngleCacheNode::aStashedInput, true);
+
+    MIntArray indices;
+    stashPlug.getExistingArrayAttributeIndices(indices);
+
+    for (unsigned i = 0; i < indices.length(); i++)
+    {
+        MPlug element = stashPlug.elementByLogicalIndex(indices[i]);
+        MPlug input = inputPlug.elementByLogicalIndex(indices[i]);
+
+        MObject sourceNode;
+        MString attribute;
+        MPlug source;
+
+        if (
+            AngleCacheNode::stashedSource(element, sourceNode, attribute)
+            && findSourcePlug(sourceNode, attribute, source)
+        ) {
+            if (!input.isConnected())
+            {
+                status = dgMod_.connect(source, input);
+                CHECK_MSTATUS_AND_RETURN_IT(status);
+            }
+        }
+        else if (attribute.length() > 0)
+        {
+            displayWarning(kCOMMAND_NAME + ": the source of " + input.name() + " no longer exists; it is not reconnected.");
+        }
+
+        status = dgMod_.removeMultiInstance(element, true);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    }
+
+    return MS::kSuccess;
+}
+
+MStatus BakeAngleCacheCommand::stashInputs(MFnDependencyNode& fnNode)
+{
+    MStatus status;
+
+    MPlug inputPlug = fnNode.findPlug(AngleCacheNode::aInput, true);
+    MPlug stashPlug = fnNode.findPlug(AngleCacheNode::aStashedInput, true);
+
+    MIntArray indices;
+    inputPlug.getExistingArrayAttributeIndices(indices);
+
+    for (unsigned i = 0; i < indices.length(); i++)
+    {
+        MPlug input = inputPlug.elementByLogicalIndex(indices[i]);
+
+        MPlugArray sources;
+        input.connectedTo(sources, true, false);
+
+        if (sources.length() == 0) continue;
+
+        MPlug element = stashPlug.elementByLogicalIndex(indices[i]);
+        MPlug sourceMessage = MFnDependencyNode(sources[0].node()).findPlug("message", true);
+
+        status = dgMod_.connect(sourceMessage, element.child(AngleCacheNode::aStashedNode));
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        status = dgMod_.newPlugValueString(
+            element.child(AngleCacheNode::aStashedAttribute),
+            AngleCacheNode::attributePath(sources[0])
+        );
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        status = dgMod_.disconnect(sources[0], input);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    }
+
+    return MS::kSuccess;
+}
+
+// Unmaps the cache file in every angleCache node that plays it back, so that
+// it can be replaced. Returns the nodes that were released.
+static void releaseCacheFile(const MString& path, MObjectArray& released)
+{
+    MItDependencyNodes iter(MFn::kPluginDependNode);
+
+    for (; !iter.isDone(); iter.next())
+    {
+        MFnDependencyNode fnNode(iter.thisNode());
+
+        if (fnNode.typeId() != AngleCacheNode::kNODE_ID) continue;
+
+        if (fnNode.findPlug(AngleCacheNode::aCacheFile, true).asString() == path)
+        {
+            ((AngleCacheNode*) fnNode.userNode())->releaseCache();
+            released.append(iter.thisNode());
+        }
+    }
+}
+
+MStatus BakeAngleCacheCommand::checkCache(MFnDependencyNode& fnNode, const MString& filePath)
+{
+    MStatus status;
+
+    AngleCacheHeader header;
+    std::vector<uint32_t> indices;
+
+    if (!AngleCacheNode::readCacheLayout(filePath, header, indices))
+    {
+        displayError(kCOMMAND_NAME + ": '" + filePath + "' is not a cache file of this version.");
+        return MS::kFailure;
+    }
+
+    AngleCacheNode* cacheNode = (AngleCacheNode*) fnNode.userNode();
+
+    bool isStale = header.signature != cacheNode->upstreamSignature();
+
+    MPlug inputPlug = fnNode.findPlug(AngleCacheNode::aInput, true);
+    MPlug stashPlug = fnNode.findPlug(AngleCacheNode::aStashedInput, true);
+
+    MIntArray stashedIndices;
+    stashPlug.getExistingArrayAttributeIndices(stashedIndices);
+
+    // Connected and unconnected inputs are read through the node, stashed
+    // inputs straight from their sources.
+    std::vector<MPlug> channelPlugs(indices.size());
+
+    for (size_t c = 0; c < indices.size() && !isStale; c++)
+    {
+        channelPlugs[c] = inputPlug.elementByLogicalIndex(indices[c]);
+
+        for (unsigned s = 0; s < stashedIndices.length(); s++)
+        {
+            if ((uint32_t) stashedIndices[s] != indices[c] || channelPlugs[c].isConnected()) continue;
+
+            MObject sourceNode;
+            MString attribute;
+
+            isStale = !(
+                AngleCacheNode::stashedSource(stashPlug.elementByLogicalIndex(indices[c]), sourceNode, attribute)
+                && findSourcePlug(sourceNode, attribute, channelPlugs[c])
+            );
+        }
+    }
+
+    if (!isStale)
+    {
+        std::vector<double> values;
+        sampleChannels(channelPlugs, header, values);
+
+        isStale = AngleCacheNode::valuesChecksum(values) != header.checksum;
+    }
+
+    setResult(isStale);
+
+    return MS::kSuccess;
+}
+
+MStatus BakeAngleCacheCommand::connectTime(MFnDependencyNode& fnNode)
+{
+    MPlug timePlug = fnNode.findPlug(AngleCacheNode::aTime, true);
+
+    if (timePlug.isConnected())
+    {
+        return MS::kSuccess;
+    }
+
+    MItDependencyNodes iter(MFn::kTime);
+
+    if (iter.isDone())
+    {
+        displayError(kCOMMAND_NAME + ": the scene has no time node to connect to " + timePlug.name() + ".");
+        return MS::kFailure;
+    }
+
+    MPlug outTimePlug = MFnDependencyNode(iter.thisNode()).findPlug("outTime", true);
+
+    return dgMod_.connect(outTimePlug, timePlug);
+}
+
+MStatus BakeAngleCacheCommand::doIt(const MArgList& argList)
+{
+    MStatus status;
+
+    MArgDatabase argData(syntax(), argList, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MSelectionList selection;
+    argData.getObjects(selection);
+
+    MObject node;
+    selection.getDependNode(0, node);
+
+    MFnDependencyNode fnNode(node, &status);
+
+    if (!status || fnNode.typeId() != AngleCacheNode::kNODE_ID)
+    {
+        displayError(kCOMMAND_NAME + ": an " + AngleCacheNode::kNODE_NAME + " node must be given or selected.");
+        return MS::kInvalidParameter;
+    }
+
+    AngleCacheNode* cacheNode = (AngleCacheNode*) fnNode.userNode();
+
+    MPlug cacheFilePlug = fnNode.findPlug(AngleCacheNode::aCacheFile, true);
+    MPlug cacheModePlug = fnNode.findPlug(AngleCacheNode::aCacheMode, true);
+    MPlug inputPlug = fnNode.findPlug(AngleCacheNode::aInput, true);
+
+    if (argData.isFlagSet(RESTORE_FLAG))
+    {
+        status = this->restoreInputs(fnNode);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        status = dgMod_.newPlugValueShort(cacheModePlug, CACHE_MODE_LIVE);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+
+        return dgMod_.doIt();
+    }
+
+    double startFrame = MAnimControl::minTime().as(MTime::uiUnit());
+    double endFrame = MAnimControl::maxTime().as(MTime::uiUnit());
+    MString filePath = cacheFilePlug.asString();
+
+    if (argData.isFlagSet(START_FRAME_FLAG)) argData.getFlagArgument(START_FRAME_FLAG, 0, startFrame);
+    if (argData.isFlagSet(END_FRAME_FLAG)) argData.getFlagArgument(END_FRAME_FLAG, 0, endFrame);
+    if (argData.isFlagSet(FILE_FLAG)) argData.getFlagArgument(FILE_FLAG, 0, filePath);
+
+    if (filePath.length() == 0)
+    {
+        displayError(kCOMMAND_NAME + ": no cache file given and " + fnNode.name() + ".cacheFile is empty.");
+        return MS::kInvalidParameter;
+    }
+
+    if (argData.isFlagSet(CHECK_FLAG))
+    {
+        return this->checkCache(fnNode, filePath);
+    }
+
+    if (endFrame < startFrame)
+    {
+        displayError(kCOMMAND_NAME + ": -endFrame must not be before -startFrame.");
+        return MS::kInvalidParameter;
+    }
+
+    // The inputs must be live to be sampled, and the node must follow the
+    // scene time to play the cache back.
+    status = this->restoreInputs(fnNode);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    status = this->connectTime(fnNode);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    status = dgMod_.doIt();
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MIntArray indices;
+    inputPlug.getExistingArrayAttributeIndices(indices);
+
+    uint32_t channelCount = indices.length();
+
+    AngleCacheHeader header;
+    memcpy(header.magic, ANGLE_CACHE_MAGIC, sizeof(ANGLE_CACHE_MAGIC));
+    header.version = ANGLE_CACHE_VERSION;
+    header.channelCount = channelCount;
+    header.frameCount = (uint32_t) (endFrame - startFrame) + 1;
+    header.reserved = 0;
+    header.startSeconds = MTime(startFrame, MTime::uiUnit()).as(MTime::kSeconds);
+    header.frameSeconds = MTime(1.0, MTime::uiUnit()).as(MTime::kSeconds);
+    header.signature = cacheNode->upstreamSignature();
+
+    std::vector<uint32_t> channelIndices(channelCount);
+    std::vector<MPlug> channelPlugs(channelCount);
+    std::vector<double> values;
+
+    for (uint32_t c = 0; c < channelCount; c++)
+    {
+        channelIndices[c] = (uint32_t) indices[c];
+        channelPlugs[c] = inputPlug.elementByLogicalIndex(indices[c]);
+    }
+
+    sampleChannels(channelPlugs, header, values);
+
+    header.checksum = AngleCacheNode::valuesChecksum(values);
+
+    // A mapped file cannot be replaced on Windows, so every node that plays
+    // it back lets go of it first and loads the new file on its next compute.
+    MObjectArray released;
+    cacheNode->releaseCache();
+    releaseCacheFile(filePath, released);
+
+    status = AngleCacheNode::writeCache(filePath, header, channelIndices, values);
+
+    if (!status)
+    {
+        displayError(kCOMMAND_NAME + ": could not write '" + filePath + "'; it may be open in another application.");
+        dgMod_.undoIt();
+        return status;
+    }
+
+    // Setting the unchanged path dirties the outputs of the other nodes, so
+    // that they play back the new file.
+    for (unsigned i = 0; i < released.length(); i++)
+    {
+        if (released[i] == node) continue;
+
+        MPlug releasedFilePlug = MFnDependencyNode(released[i]).findPlug(AngleCacheNode::aCacheFile, true);
+
+        status = dgMod_.newPlugValueString(releasedFilePlug, filePath);
+        CHECK_MSTATUS_AND_RETURN_IT(status);
+    }
+
+    status = this->stashInputs(fnNode);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    status = dgMod_.newPlugValueString(cacheFilePlug, filePath);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    status = dgMod_.newPlugValueShort(cacheModePlug, CACHE_MODE_CACHED);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    status = dgMod_.doIt();
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    setResult(filePath);
+
+    return MS::kSuccess;
+}
\ No newline at end of file
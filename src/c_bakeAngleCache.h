@@ -0,0 +1,35 @@
+#ifndef C_BAKE_ANGLE_CACHE_H
+#define C_BAKE_ANGLE_CACHE_H
+
+#include <maya/MArgList.h>
+#include <maya/MDGModifier.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MPxCommand.h>
+#include <maya/MString.h>
+#include <maya/MSyntax.h>
+
+class BakeAngleCacheCommand : public MPxCommand
+{
+public:
+    virtual MStatus         doIt(const MArgList& argList);
+    virtual MStatus         redoIt();
+    virtual MStatus         undoIt();
+    virtual bool            isUndoable() const;
+
+    static  void*           creator();
+    static  MSyntax         newSyntax();
+
+public:
+    static MString          kCOMMAND_NAME;
+
+private:
+    MStatus                 restoreInputs(MFnDependencyNode& fnNode);
+    MStatus                 stashInputs(MFnDependencyNode& fnNode);
+    MStatus                 connectTime(MFnDependencyNode& fnNode);
+    MStatus                 checkCache(MFnDependencyNode& fnNode, const MString& filePath);
+
+private:
+    MDGModifier             dgMod_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,574 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+//-----------------------------------------------------------------------------
+//  buildAngularNetwork command
+//
+//  Creates a network of nodes from a JSON description in a single
+//  MDagModifier, so the whole network is built (and undone) in one step
+//  instead of through one command per node, attribute and connection.
+//
+//  {
+//      "nodes": [
+//          {
+//              "name": "elbow_clamp",
+//              "type": "clampAngle",
+//              "attributes": {"min": -10, "max": 150}
+//          }
+//      ],
+//      "connections": [
+//          ["elbow_jnt.rotateZ", "elbow_clamp.input"],
+//          ["elbow_clamp.output", "elbow_driver.rotateZ"]
+//      ]
+//  }
+//
+//  Nodes may be of any type, so stock nodes can be part of the network. DAG
+//  nodes are created under the world; shapes get a parent transform, which is
+//  the node that is named and returned.
+//  Attribute names may include array indices and child names, such as
+//  "input[3]" or "pose[0].poseRotateX". Values are numbers (angles in
+//  degrees), booleans, strings (enum field names or string attributes), or
+//  arrays that set the children of a compound attribute. Connections may
+//  refer to nodes in the description or to nodes already in the scene.
+//
+//  Flags
+//      -file           (-f)    Path of the JSON file to read.
+//      -description    (-d)    JSON text to read instead of a file.
+//
+//  Returns the names of the created nodes.
+//-----------------------------------------------------------------------------
+
+#include "c_buildAngularNetwork.h"
+#include "json.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <maya/MAngle.h>
+#include <maya/MArgDatabase.h>
+#include <maya/MArgList.h>
+#include <maya/MDagModifier.h>
+#include <maya/MFn.h>
+#include <maya/MFnAttribute.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MFnEnumAttribute.h>
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
+#include <maya/MFnUnitAttribute.h>
+#include <maya/MGlobal.h>
+#include <maya/MObject.h>
+#include <maya/MPlug.h>
+#include <maya/MPxCommand.h>
+#include <maya/MSelectionList.h>
+#include <maya/MString.h>
+#include <maya/MStringArray.h>
+#include <maya/MSyntax.h>
+#include <maya/MTime.h>
+
+#define FILE_FLAG                   "-f"
+#define FILE_LONG_FLAG              "-file"
+#define DESCRIPTION_FLAG            "-d"
+#define DESCRIPTION_LONG_FLAG       "-description"
+
+void* BuildAngularNetworkCommand::creator()
+{
+    return new BuildAngularNetworkCommand();
+}
+
+MSyntax BuildAngularNetworkCommand::newSyntax()
+{
+    MSyntax syntax;
+
+    syntax.addFlag(FILE_FLAG, FILE_LONG_FLAG, MSyntax::kString);
+    syntax.addFlag(DESCRIPTION_FLAG, DESCRIPTION_LONG_FLAG, MSyntax::kString);
+
+    return syntax;
+}
+
+bool BuildAngularNetworkCommand::isUndoable() const
+{
+    return true;
+}
+
+MStatus BuildAngularNetworkCommand::doIt(const MArgList& argList)
+{
+    MStatus status;
+
+    MArgDatabase argData(syntax(), argList, &status);
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    std::string text;
+
+    if (argData.isFlagSet(DESCRIPTION_FLAG))
+    {
+        MString description;
+        argData.getFlagArgument(DESCRIPTION_FLAG, 0, description);
+        text = description.asChar();
+    }
+    else if (argData.isFlagSet(FILE_FLAG))
+    {
+        MString filePath;
+        argData.getFlagArgument(FILE_FLAG, 0, filePath);
+
+        std::ifstream file(filePath.asChar(), std::ios::in | std::ios::binary);
+
+        if (!file)
+        {
+            displayError(kCOMMAND_NAME + ": could not open '" + filePath + "'.");
+            return MS::kFailure;
+        }
+
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        text = contents.str();
+    }
+    else
+    {
+        displayError(kCOMMAND_NAME + ": one of -file or -description must be given.");
+        return MS::kInvalidParameter;
+    }
+
+    JsonValue root;
+    std::string error;
+
+    if (!parseJson(text, root, error))
+    {
+        displayError(kCOMMAND_NAME + ": invalid JSON, " + error.c_str() + ".");
+        return MS::kFailure;
+    }
+
+    if (root.type != JsonValue::kObject)
+    {
+        displayError(kCOMMAND_NAME + ": the description must be a JSON object.");
+        return MS::kFailure;
+    }
+
+    const JsonValue* nodes = root.find("nodes");
+    const JsonValue* connections = root.find("connections");
+
+    if (nodes != NULL)
+    {
+        status = this->createNodes(*nodes);
+        if (!status) return status;
+    }
+
+    if (connections != NULL)
+    {
+        status = this->connectPlugs(*connections);
+        if (!status) return status;
+    }
+
+    return this->redoIt();
+}
+
+MStatus BuildAngularNetworkCommand::redoIt()
+{
+    MStatus status = dagMod_.doIt();
+    CHECK_MSTATUS_AND_RETURN_IT(status);
+
+    MStringArray result;
+
+    for (unsigned i = 0; i < createdNodes_.length(); i++)
+    {
+        result.append(MFnDependencyNode(createdNodes_[i]).name());
+    }
+
+    clearResult();
+    setResult(result);
+
+    return MS::kSuccess;
+}
+
+MStatus BuildAngularNetworkCommand::undoIt()
+{
+    return dagMod_.undoIt();
+}
+
+// Returns true if the node type is a DAG node type, which must be created by
+// the DAG part of the modifier. Results are cached per type, so a network of
+// many nodes of the same type only queries Maya once.
+bool BuildAngularNetworkCommand::isDagType(const std::string& type)
+{
+    std::map<std::string, bool>::const_iterator it = dagTypes_.find(type);
+
+    if (it != dagTypes_.end())
+    {
+        return it->second;
+    }
+
+    bool isDag = false;
+
+    MStringArray inherited;
+    MGlobal::executeCommand(MString("nodeType -isTypeName -inherited \"") + type.c_str() + "\"", inherited);
+
+    for (unsigned i = 0; i < inherited.length(); i++)
+    {
+        isDag = isDag || inherited[i] == "dagNode";
+    }
+
+    dagTypes_[type] = isDag;
+
+    return isDag;
+}
+
+MStatus BuildAngularNetworkCommand::createNodes(const JsonValue& nodes)
+{
+    MStatus status;
+
+    if (nodes.type != JsonValue::kArray)
+    {
+        displayError(kCOMMAND_NAME + ": \"nodes\" must be an array.");
+        return MS::kFailure;
+    }
+
+    for (size_t i = 0; i < nodes.array.size(); i++)
+    {
+        const JsonValue& node = nodes.array[i];
+        const JsonValue* name = node.find("name");
+        const JsonValue* type = node.find("type");
+        const JsonValue* attributes = node.find("attributes");
+
+        if (type == NULL || type->type != JsonValue::kString)
+        {
+            displayError(kCOMMAND_NAME + ": every node needs a \"type\" string.");
+            return MS::kFailure;
+        }
+
+        MObject obj;
+
+        if (this->isDagType(type->string))
+        {
+            obj = dagMod_.createNode(type->string.c_str(), MObject::kNullObj, &status);
+        }
+        else
+        {
+            obj = dagMod_.MDGModifier::createNode(type->string.c_str(), &status);
+        }
+
+        if (!status)
+        {
+            displayError(kCOMMAND_NAME + ": could not create a node of type '" + type->string.c_str() + "'.");
+            return status;
+        }
+
+        createdNodes_.append(obj);
+
+        if (name != NULL && name->type == JsonValue::kString)
+        {
+            if (namedNodes_.count(name->string) != 0)
+            {
+                displayError(kCOMMAND_NAME + ": more than one node is named '" + name->string.c_str() + "'.");
+                return MS::kFailure;
+            }
+
+            dagMod_.renameNode(obj, name->string.c_str());
+            namedNodes_[name->string] = obj;
+        }
+
+        if (attributes == NULL) continue;
+
+        for (size_t a = 0; a < attributes->keys.size(); a++)
+        {
+            MPlug plug;
+            const std::string& path = attributes->keys[a];
+
+            status = this->findPlug(obj, path, plug);
+            if (!status) return status;
+
+            status = this->setValue(plug, attributes->array[a]);
+
+            if (!status)
+            {
+                displayError(kCOMMAND_NAME + ": could not set '" + path.c_str() + "' on a " + type->string.c_str() + " node.");
+                return status;
+            }
+        }
+    }
+
+    return MS::kSuccess;
+}
+
+MStatus BuildAngularNetworkCommand::setValue(const MPlug& plug, const JsonValue& value)
+{
+    MObject attribute = plug.attribute();
+
+    if (value.type == JsonValue::kArray)
+    {
+        if (plug.numChildren() != value.array.size()) return MS::kInvalidParameter;
+
+        for (unsigned i = 0; i < plug.numChildren(); i++)
+        {
+            MStatus status = this->setValue(plug.child(i), value.array[i]);
+            if (!status) return status;
+        }
+
+        return MS::kSuccess;
+    }
+
+    if (value.type == JsonValue::kString)
+    {
+        if (attribute.hasFn(MFn::kEnumAttribute))
+        {
+            MStatus status;
+            short index = MFnEnumAttribute(attribute).fieldIndex(value.string.c_str(), &status);
+            if (!status) return status;
+
+            return dagMod_.newPlugValueShort(plug, index);
+        }
+
+        return dagMod_.newPlugValueString(plug, value.string.c_str());
+    }
+
+    double number = value.type == JsonValue::kBool ? (value.boolean ? 1.0 : 0.0) : value.number;
+
+    if (value.type != JsonValue::kBool && value.type != JsonValue::kNumber)
+    {
+        return MS::kInvalidParameter;
+    }
+
+    if (attribute.hasFn(MFn::kUnitAttribute))
+    {
+        switch (MFnUnitAttribute(attribute).unitType())
+        {
+            case MFnUnitAttribute::kAngle:
+                return dagMod_.newPlugValueMAngle(plug, MAngle(number, MAngle::kDegrees));
+
+            case MFnUnitAttribute::kTime:
+                return dagMod_.newPlugValueMTime(plug, MTime(number, MTime::uiUnit()));
+
+            default:
+                return dagMod_.newPlugValueDouble(plug, number);
+        }
+    }
+
+    if (attribute.hasFn(MFn::kEnumAttribute))
+    {
+        return dagMod_.newPlugValueShort(plug, (short) number);
+    }
+
+    if (attribute.hasFn(MFn::kNumericAttribute))
+    {
+        switch (MFnNumericAttribute(attribute).unitType())
+        {
+            case MFnNumericData::kBoolean:
+                return dagMod_.newPlugValueBool(plug, number != 0.0);
+
+            case MFnNumericData::kByte:
+            case MFnNumericData::kChar:
+            case MFnNumericData::kShort:
+                return dagMod_.newPlugValueShort(plug, (short) number);
+
+            case MFnNumericData::kInt:
+                return dagMod_.newPlugValueInt(plug, (int) number);
+
+            case MFnNumericData::kFloat:
+                return dagMod_.newPlugValueFloat(plug, (float) number);
+
+            default:
+                return dagMod_.newPlugValueDouble(plug, number);
+        }
+    }
+
+    return MS::kInvalidParameter;
+}
+
+MStatus BuildAngularNetworkCommand::connectPlugs(const JsonValue& connections)
+{
+    MStatus status;
+
+    if (connections.type != JsonValue::kArray)
+    {
+        displayError(kCOMMAND_NAME + ": \"connections\" must be an array.");
+        return MS::kFailure;
+    }
+
+    for (size_t i = 0; i < connections.array.size(); i++)
+    {
+        const JsonValue& connection = connections.array[i];
+
+        bool isValid = (
+            connection.type == JsonValue::kArray
+            && connection.array.size() == 2
+            && connection.array[0].type == JsonValue::kString
+            && connection.array[1].type == JsonValue::kString
+        );
+
+        if (!isValid)
+        {
+            displayError(kCOMMAND_NAME + ": every connection must be a pair of plug names.");
+            return MS::kFailure;
+        }
+
+        MPlug source;
+        MPlug destination;
+
+        status = this->findPlug(connection.array[0].string, source);
+        if (!status) return status;
+
+        status = this->findPlug(connection.array[1].string, destination);
+        if (!status) return status;
+
+        status = dagMod_.connect(source, destination);
+
+        if (!status)
+        {
+            displayError(
+                kCOMMAND_NAME + ": could not connect '" + connection.array[0].string.c_str()
+                + "' to '" + connection.array[1].string.c_str() + "'."
+            );
+            return status;
+        }
+    }
+
+    return MS::kSuccess;
+}
+
+// Resolves "node.attr[index].child" to a plug. The node is looked up among
+// the named nodes in the description first and then in the scene.
+MStatus BuildAngularNetworkCommand::findPlug(const std::string& path, MPlug& plug)
+{
+    MStatus status;
+
+    size_t dot = path.find('.');
+
+    if (dot == std::string::npos || dot == 0)
+    {
+        displayError(kCOMMAND_NAME + ": '" + path.c_str() + "' is not a node.attribute name.");
+        return MS::kInvalidParameter;
+    }
+
+    std::string nodeName = path.substr(0, dot);
+    MObject node;
+
+    std::map<std::string, MObject>::const_iterator it = namedNodes_.find(nodeName);
+
+    if (it != namedNodes_.end())
+    {
+        node = it->second;
+    }
+    else
+    {
+        MSelectionList selection;
+        status = selection.add(nodeName.c_str());
+        if (status) status = selection.getDependNode(0, node);
+
+        if (!status)
+        {
+            displayError(kCOMMAND_NAME + ": no node named '" + nodeName.c_str() + "'.");
+            return MS::kNotFound;
+        }
+    }
+
+    return this->findPlug(node, path.substr(dot + 1), plug);
+}
+
+// Resolves "attr[index].child" on the given node to a plug. A child may be
+// named without its intermediate parents, so "pose[0].poseRotateX" resolves
+// to "pose[0].poseRotate.poseRotateX".
+MStatus BuildAngularNetworkCommand::findPlug(const MObject& node, const std::string& path, MPlug& plug)
+{
+    MStatus status;
+
+    MFnDependencyNode fnNode(node);
+
+    size_t start = 0;
+    bool isFirst = true;
+
+    while (start <= path.size())
+    {
+        size_t end = path.find('.', start);
+        if (end == std::string::npos) end = path.size();
+
+        std::string segment = path.substr(start, end - start);
+        size_t bracket = segment.find('[');
+        std::string attributeName = segment.substr(0, bracket);
+
+        MObject attribute = fnNode.attribute(attributeName.c_str(), &status);
+
+        if (!status || attribute.isNull())
+        {
+            displayError(kCOMMAND_NAME + ": no attribute named '" + attributeName.c_str() + "' in '" + path.c_str() + "'.");
+            return MS::kNotFound;
+        }
+
+        if (isFirst)
+        {
+            plug = MPlug(node, attribute);
+            isFirst = false;
+        }
+        else
+        {
+            if (plug.isArray())
+            {
+                displayError(kCOMMAND_NAME + ": '" + plug.partialName(false, false, false, false, false, true) + "' needs an index in '" + path.c_str() + "'.");
+                return MS::kInvalidParameter;
+            }
+
+            MObjectArray parents;
+            MObject parent = attribute;
+
+            while (!parent.isNull() && parent != plug.attribute())
+            {
+                parents.append(parent);
+                parent = MFnAttribute(parent).parent();
+            }
+
+            if (parent.isNull())
+            {
+                displayError(kCOMMAND_NAME + ": '" + attributeName.c_str() + "' is not a child of '" + plug.partialName(false, false, false, false, false, true) + "' in '" + path.c_str() + "'.");
+                return MS::kInvalidParameter;
+            }
+
+            for (int i = (int) parents.length() - 1; i >= 0; i--)
+            {
+                plug = plug.child(parents[i], &status);
+
+                if (!status)
+                {
+                    displayError(kCOMMAND_NAME + ": could not get '" + attributeName.c_str() + "' in '" + path.c_str() + "'; intermediate arrays need an index.");
+                    return MS::kInvalidParameter;
+                }
+            }
+        }
+
+        if (bracket != std::string::npos)
+        {
+            size_t close = segment.size() - 1;
+
+            bool isValidIndex = (
+                close > bracket + 1
+                && segment[close] == ']'
+                && segment.find_first_not_of("0123456789", bracket + 1) == close
+            );
+
+            errno = 0;
+            unsigned long index = isValidIndex ? strtoul(segment.c_str() + bracket + 1, NULL, 10) : 0;
+
+            if (!isValidIndex || errno == ERANGE || index > UINT_MAX)
+            {
+                displayError(kCOMMAND_NAME + ": '" + segment.c_str() + "' has an invalid array index in '" + path.c_str() + "'.");
+                return MS::kInvalidParameter;
+            }
+
+            if (!plug.isArray())
+            {
+                displayError(kCOMMAND_NAME + ": '" + attributeName.c_str() + "' is not an array in '" + path.c_str() + "'.");
+                return MS::kInvalidParameter;
+            }
+
+            plug = plug.elementByLogicalIndex((unsigned) index, &status);
+            CHECK_MSTATUS_AND_RETURN_IT(status);
+        }
+
+        start = end + 1;
+    }
+
+    return MS::kSuccess;
+}
\ No newline at end of file
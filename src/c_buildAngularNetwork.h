@@ -0,0 +1,47 @@
+#ifndef C_BUILD_ANGULAR_NETWORK_H
+#define C_BUILD_ANGULAR_NETWORK_H
+
+#include <map>
+#include <string>
+
+#include <maya/MArgList.h>
+#include <maya/MDagModifier.h>
+#include <maya/MObject.h>
+#include <maya/MObjectArray.h>
+#include <maya/MPlug.h>
+#include <maya/MPxCommand.h>
+#include <maya/MString.h>
+#include <maya/MSyntax.h>
+
+class JsonValue;
+
+class BuildAngularNetworkCommand : public MPxCommand
+{
+public:
+    virtual MStatus         doIt(const MArgList& argList);
+    virtual MStatus         redoIt();
+    virtual MStatus         undoIt();
+    virtual bool            isUndoable() const;
+
+    static  void*           creator();
+    static  MSyntax         newSyntax();
+
+public:
+    static MString          kCOMMAND_NAME;
+
+private:
+    MStatus                 createNodes(const JsonValue& nodes);
+    MStatus                 setValue(const MPlug& plug, const JsonValue& value);
+    MStatus                 connectPlugs(const JsonValue& connections);
+    MStatus                 findPlug(const std::string& path, MPlug& plug);
+    MStatus                 findPlug(const MObject& node, const std::string& path, MPlug& plug);
+    bool                    isDagType(const std::string& type);
+
+private:
+    MDagModifier                        dagMod_;
+    MObjectArray                        createdNodes_;
+    std::map<std::string, MObject>      namedNodes_;
+    std::map<std::string, bool>         dagTypes_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,217 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "json.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+JsonValue::JsonValue() : type(kNull), boolean(false), number(0.0)
+{
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const
+{
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (keys[i] == key) return &array[i];
+    }
+
+    return NULL;
+}
+
+class JsonParser
+{
+public:
+    JsonParser(const std::string& text) : text_(text), pos_(0) {}
+
+    bool parseDocument(JsonValue& value, std::string& error)
+    {
+        bool ok = parseValue(value) && (skipWhitespace(), pos_ == text_.size() || fail("unexpected trailing characters"));
+
+        if (!ok)
+        {
+            std::ostringstream message;
+            message << error_ << " at character " << pos_;
+            error = message.str();
+        }
+
+        return ok;
+    }
+
+private:
+    bool fail(const char* message)
+    {
+        if (error_.empty()) error_ = message;
+        return false;
+    }
+
+    void skipWhitespace()
+    {
+        while (pos_ < text_.size() && strchr(" \t\r\n", text_[pos_]) != NULL) pos_++;
+    }
+
+    bool consume(char c)
+    {
+        skipWhitespace();
+
+        if (pos_ < text_.size() && text_[pos_] == c)
+        {
+            pos_++;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool consumeWord(const char* word)
+    {
+        size_t length = strlen(word);
+
+        if (text_.compare(pos_, length, word) == 0)
+        {
+            pos_ += length;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool parseValue(JsonValue& value)
+    {
+        skipWhitespace();
+
+        if (pos_ >= text_.size()) return fail("unexpected end of input");
+
+        char c = text_[pos_];
+
+        if (c == '{') return parseObject(value);
+        if (c == '[') return parseArray(value);
+        if (c == '"') { value.type = JsonValue::kString; return parseString(value.string); }
+
+        if (consumeWord("true"))  { value.type = JsonValue::kBool; value.boolean = true; return true; }
+        if (consumeWord("false")) { value.type = JsonValue::kBool; value.boolean = false; return true; }
+        if (consumeWord("null"))  { value.type = JsonValue::kNull; return true; }
+
+        return parseNumber(value);
+    }
+
+    bool parseNumber(JsonValue& value)
+    {
+        const char* start = text_.c_str() + pos_;
+        char* end = NULL;
+
+        value.number = strtod(start, &end);
+
+        if (end == start) return fail("expected a value");
+
+        // strtod also accepts nan, inf and hex numbers, which JSON does not.
+        if (*start != '-' && (*start < '0' || *start > '9')) return fail("expected a value");
+        if (strspn(start, "0123456789+-.eE") < (size_t) (end - start)) return fail("invalid number");
+
+        // Rejects numbers that overflow to infinity, such as 1e999.
+        if (value.number - value.number != 0.0) return fail("number is out of range");
+
+        value.type = JsonValue::kNumber;
+        pos_ += end - start;
+
+        return true;
+    }
+
+    bool parseString(std::string& result)
+    {
+        pos_++;
+        result.clear();
+
+        while (pos_ < text_.size())
+        {
+            char c = text_[pos_++];
+
+            if (c == '"') return true;
+
+            if (c == '\\')
+            {
+                if (pos_ >= text_.size()) break;
+
+                char escaped = text_[pos_++];
+
+                switch (escaped)
+                {
+                    case 'n': result += '\n'; break;
+                    case 't': result += '\t'; break;
+                    case 'r': result += '\r'; break;
+                    case 'b': result += '\b'; break;
+                    case 'f': result += '\f'; break;
+                    case 'u': return fail("unicode escapes are not supported");
+                    default:  result += escaped; break;
+                }
+            }
+            else
+            {
+                result += c;
+            }
+        }
+
+        return fail("unterminated string");
+    }
+
+    bool parseArray(JsonValue& value)
+    {
+        pos_++;
+        value.type = JsonValue::kArray;
+
+        if (consume(']')) return true;
+
+        do
+        {
+            value.array.push_back(JsonValue());
+            if (!parseValue(value.array.back())) return false;
+        } while (consume(','));
+
+        return consume(']') || fail("expected ',' or ']'");
+    }
+
+    bool parseObject(JsonValue& value)
+    {
+        pos_++;
+        value.type = JsonValue::kObject;
+
+        if (consume('}')) return true;
+
+        do
+        {
+            skipWhitespace();
+
+            if (pos_ >= text_.size() || text_[pos_] != '"') return fail("expected a member name");
+
+            value.keys.push_back(std::string());
+            if (!parseString(value.keys.back())) return false;
+
+            if (!consume(':')) return fail("expected ':'");
+
+            value.array.push_back(JsonValue());
+            if (!parseValue(value.array.back())) return false;
+        } while (consume(','));
+
+        return consume('}') || fail("expected ',' or '}'");
+    }
+
+private:
+    const std::string&  text_;
+    size_t              pos_;
+    std::string         error_;
+};
+
+bool parseJson(const std::string& text, JsonValue& value, std::string& error)
+{
+    value = JsonValue();
+
+    JsonParser parser(text);
+    return parser.parseDocument(value, error);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef N_JSON_H
+#define N_JSON_H
+
+//-----------------------------------------------------------------------------
+//  Minimal JSON reader used by the plug-in commands.
+//
+//  Parses a complete document into a tree of JsonValues. Numbers are stored 
+//  as doubles and strings are not unescaped beyond the basic escapes.
+//-----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+class JsonValue
+{
+public:
+    enum Type { kNull, kBool, kNumber, kString, kArray, kObject };
+
+                                        JsonValue();
+
+    Type                                type;
+    bool                                boolean;
+    double                              number;
+    std::string                         string;
+    std::vector<JsonValue>              array;     // Elements, or object member values.
+    std::vector<std::string>            keys;      // Object member names, in document order.
+
+    // Returns the member with the given key, or null if there is none.
+    const JsonValue*                    find(const std::string& key) const;
+};
+
+// Parses text into value. Returns false and describes the problem in error
+// if the text is not valid JSON.
+bool parseJson(const std::string& text, JsonValue& value, std::string& error);
+
+#endif
\ No newline at end of file
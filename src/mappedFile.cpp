@@ -0,0 +1,137 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "mappedFile.h"
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <stdio.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : 
+    data_(NULL), 
+    size_(0)
+#ifdef _WIN32
+    , file_(INVALID_HANDLE_VALUE)
+    , mapping_(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    this->close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char* path)
+{
+    this->close();
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (mapping == NULL)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (view == NULL)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_ = file;
+    mapping_ = mapping;
+    data_ = (const char*) view;
+    size_ = (size_t) fileSize.QuadPart;
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_ != NULL) UnmapViewOfFile(data_);
+    if (mapping_ != NULL) CloseHandle((HANDLE) mapping_);
+    if (file_ != INVALID_HANDLE_VALUE) CloseHandle((HANDLE) file_);
+
+    data_ = NULL;
+    size_ = 0;
+    file_ = INVALID_HANDLE_VALUE;
+    mapping_ = NULL;
+}
+
+bool replaceFile(const char* from, const char* to)
+{
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+#else
+
+bool MappedFile::open(const char* path)
+{
+    this->close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+
+    if (view == MAP_FAILED) return false;
+
+    data_ = (const char*) view;
+    size_ = (size_t) info.st_size;
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_ != NULL) munmap((void*) data_, size_);
+
+    data_ = NULL;
+    size_ = 0;
+}
+
+bool replaceFile(const char* from, const char* to)
+{
+    return rename(from, to) == 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef N_MAPPED_FILE_H
+#define N_MAPPED_FILE_H
+
+//-----------------------------------------------------------------------------
+//  Read-only memory mapping of a whole file.
+//
+//  Files that are mapped should be replaced with replaceFile() rather than
+//  rewritten in place, as truncating a mapped file would fault on the next
+//  read past its new end. On POSIX systems, existing mappings keep the old
+//  contents. On Windows, a file cannot be replaced while it is mapped, so
+//  every mapping of it must be closed first or replaceFile() fails.
+//-----------------------------------------------------------------------------
+
+#include <stddef.h>
+
+class MappedFile
+{
+public:
+                            MappedFile();
+                            ~MappedFile();
+
+    bool                    open(const char* path);
+    void                    close();
+
+    bool                    isOpen() const  { return data_ != NULL; }
+    const char*             data() const    { return data_; }
+    size_t                  size() const    { return size_; }
+
+private:
+                            MappedFile(const MappedFile&);
+    MappedFile&             operator=(const MappedFile&);
+
+private:
+    const char*             data_;
+    size_t                  size_;
+
+#ifdef _WIN32
+    void*                   file_;
+    void*                   mapping_;
+#endif
+};
+
+// Moves a file over another, replacing it in a single step.
+bool replaceFile(const char* from, const char* to);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,175 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+//-----------------------------------------------------------------------------
+//  angleBlend node
+//
+//  Blends the input values by the weight with the matching index. Inputs 
+//  without a matching weight have a weight of one.
+//      Linear          - Returns the weighted sum of the input values.
+//      Shortest Arc    - Returns the weighted circular mean of the input 
+//                        values, scaled by the sum of the weights. The mean
+//                        is unwrapped to lie within 180 degrees of the first
+//                        input with a non-zero weight.
+//
+//  When Normalize Weights is on, the result is divided by the sum of the 
+//  weights. If the weights sum to zero, the result is zero. In Shortest Arc
+//  mode, inputs that cancel each other out have a mean of zero.
+//-----------------------------------------------------------------------------
+
+#define _USE_MATH_DEFINES
+
+#include "n_angleBlend.h"
+#include "node.h"
+
+#include <math.h>
+
+#include <maya/MAngle.h>
+#include <maya/MArrayDataHandle.h>
+#include <maya/MDataHandle.h>
+#include <maya/MFnEnumAttribute.h>
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
+#include <maya/MFnUnitAttribute.h>
+#include <maya/MPlug.h>
+#include <maya/MPxNode.h>
+
+MObject AngleBlendNode::aInput;
+MObject AngleBlendNode::aWeight;
+MObject AngleBlendNode::aBlendMode;
+MObject AngleBlendNode::aNormalizeWeights;
+MObject AngleBlendNode::aOutput;
+
+const short LINEAR =        0;
+const short SHORTEST_ARC =  1;
+
+void* AngleBlendNode::creator()
+{
+    return new AngleBlendNode();
+}
+
+MStatus AngleBlendNode::initialize()
+{
+    MStatus status;
+
+    MFnEnumAttribute e;
+    MFnNumericAttribute n;
+    MFnUnitAttribute u;
+
+    aInput = u.create("input", "i", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+    u.setArray(true);
+
+    aWeight = n.create("weight", "w", MFnNumericData::kDouble, 1.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+    n.setArray(true);
+    n.setSoftMin(0.0);
+    n.setSoftMax(1.0);
+
+    aBlendMode = e.create("blendMode", "bm", LINEAR, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(e);
+
+    e.addField("Linear", LINEAR);
+    e.addField("Shortest Arc", SHORTEST_ARC);
+
+    aNormalizeWeights = n.create("normalizeWeights", "nw", MFnNumericData::kBoolean, true, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+
+    aOutput = u.create("output", "o", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_OUTPUT_ATTR(u);
+
+    addAttribute(aInput);
+    addAttribute(aWeight);
+    addAttribute(aBlendMode);
+    addAttribute(aNormalizeWeights);
+    addAttribute(aOutput);
+
+    attributeAffects(aInput, aOutput);
+    attributeAffects(aWeight, aOutput);
+    attributeAffects(aBlendMode, aOutput);
+    attributeAffects(aNormalizeWeights, aOutput);
+
+    return MS::kSuccess;
+}
+
+MStatus AngleBlendNode::compute(const MPlug& plug, MDataBlock& data)
+{
+    if (plug != aOutput) 
+    {
+        return MS::kUnknownParameter;
+    }
+
+    MArrayDataHandle inputArrayHandle = data.inputArrayValue(aInput);
+    MArrayDataHandle weightArrayHandle = data.inputArrayValue(aWeight);
+
+    short blendMode = data.inputValue(aBlendMode).asShort();
+    bool normalizeWeights = data.inputValue(aNormalizeWeights).asBool();
+
+    unsigned numInputs = inputArrayHandle.elementCount();
+    unsigned numWeights = weightArrayHandle.elementCount();
+
+    double weightedSum = 0.0;
+    double weightedSin = 0.0;
+    double weightedCos = 0.0;
+    double weightSum = 0.0;
+
+    double reference = 0.0;
+    bool hasReference = false;
+
+    for (unsigned i = 0; i < numInputs; i++)
+    {
+        double input = inputArrayHandle.inputValue().asAngle().asDegrees();
+        unsigned index = inputArrayHandle.elementIndex();
+        inputArrayHandle.next();
+
+        double weight = 1.0;
+
+        if (numWeights > 0 && weightArrayHandle.jumpToElement(index))
+        {
+            weight = weightArrayHandle.inputValue().asDouble();
+        }
+
+        if (blendMode == SHORTEST_ARC)
+        {
+            if (!hasReference && weight != 0.0)
+            {
+                reference = input;
+                hasReference = true;
+            }
+
+            double radians = input * M_PI / 180.0;
+
+            weightedSin += weight * sin(radians);
+            weightedCos += weight * cos(radians);
+        }
+
+        weightedSum += weight * input;
+        weightSum += weight;
+    }
+
+    if (blendMode == SHORTEST_ARC)
+    {
+        double mean = atan2(weightedSin, weightedCos) * 180.0 / M_PI;
+        weightedSum = (reference + wrapAngle(mean - reference)) * weightSum;
+    }
+
+    double result = weightedSum;
+
+    if (normalizeWeights)
+    {
+        result = weightSum == 0.0 ? 0.0 : weightedSum / weightSum;
+    }
+
+    MDataHandle output = data.outputValue(aOutput);
+    output.setMAngle(MAngle(result, MAngle::kDegrees));
+    output.setClean();
+
+    return MS::kSuccess;
+}
\ No newline at end of file
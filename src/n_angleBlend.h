@@ -0,0 +1,28 @@
+#ifndef N_ANGLE_BLEND_H
+#define N_ANGLE_BLEND_H
+
+#include <maya/MDataBlock.h>
+#include <maya/MPlug.h>
+#include <maya/MPxNode.h>
+#include <maya/MString.h>
+#include <maya/MTypeId.h>
+
+class AngleBlendNode : public MPxNode
+{
+public:
+    virtual MStatus         compute(const MPlug& plug, MDataBlock& data);
+    static  void*           creator();
+    static  MStatus         initialize();
+
+public:
+    static MTypeId          kNODE_ID;
+    static MString          kNODE_NAME;
+
+    static MObject          aInput;
+    static MObject          aWeight;
+    static MObject          aBlendMode;
+    static MObject          aNormalizeWeights;
+    static MObject          aOutput;
+};
+
+#endif
\ No newline at end of file
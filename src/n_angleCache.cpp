@@ -0,0 +1,579 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+//-----------------------------------------------------------------------------
+//  angleCache node
+//
+//  Passes the input angles through to the outputs, or plays them back from a
+//  cache file baked with the bakeAngleCache command.
+//      Live            - Returns the input values.
+//      Cached          - Returns the cached values for the current time,
+//                        without reading the inputs. Falls back to Live if
+//                        the cache file cannot be loaded.
+//
+//  The cache file is memory mapped and stores each channel as a contiguous
+//  array of frames, so playback is a single lookup per output. Times outside
+//  the cached range hold the first or last frame. The file is loaded once and
+//  again only when Cache File changes; bakeAngleCache releases it in every 
+//  node that plays it back before replacing it.
+//
+//  bakeAngleCache moves the input connections into Stashed Input, which 
+//  records the source node and attribute of each input, so that the upstream
+//  network is not evaluated at all while the node plays back its cache.
+//  bakeAngleCache -restore reconnects them and returns the node to Live.
+//
+//  Stale is true when the cache file cannot be loaded, when the sources of 
+//  the inputs, connected or stashed, differ from those at bake time, or when 
+//  the values of the unstashed inputs at the current time differ from the 
+//  cached values. It is only evaluated when it is queried or connected.
+//  Stashed inputs are not evaluated during playback, so edits to their
+//  upstream animation are found by bakeAngleCache -check, which samples the
+//  stashed sources and compares them against a checksum of the baked values.
+//-----------------------------------------------------------------------------
+
+#define NOMINMAX
+
+#include "n_angleCache.h"
+#include "node.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include <maya/MAngle.h>
+#include <maya/MArrayDataBuilder.h>
+#include <maya/MArrayDataHandle.h>
+#include <maya/MDataHandle.h>
+#include <maya/MFnCompoundAttribute.h>
+#include <maya/MFnData.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MFnEnumAttribute.h>
+#include <maya/MFnMessageAttribute.h>
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
+#include <maya/MFnStringData.h>
+#include <maya/MFnTypedAttribute.h>
+#include <maya/MFnUnitAttribute.h>
+#include <maya/MIntArray.h>
+#include <maya/MPlug.h>
+#include <maya/MPlugArray.h>
+#include <maya/MPxNode.h>
+#include <maya/MTime.h>
+
+#if MAYA_API_VERSION >= 201600
+#include <maya/MUuid.h>
+#endif
+
+MObject AngleCacheNode::aTime;
+MObject AngleCacheNode::aInput;
+MObject AngleCacheNode::aCacheMode;
+MObject AngleCacheNode::aCacheFile;
+MObject AngleCacheNode::aStashedInput;
+MObject AngleCacheNode::aStashedNode;
+MObject AngleCacheNode::aStashedAttribute;
+MObject AngleCacheNode::aOutput;
+MObject AngleCacheNode::aStale;
+
+// Largest difference, in degrees, between a live and a cached value that is
+// not considered stale.
+const double STALE_TOLERANCE = 1e-6;
+
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+AngleCacheNode::AngleCacheNode() :
+    isLoaded_(false),
+    header_(NULL),
+    indices_(NULL),
+    values_(NULL)
+{
+}
+
+void* AngleCacheNode::creator()
+{
+    return new AngleCacheNode();
+}
+
+MStatus AngleCacheNode::initialize()
+{
+    MStatus status;
+
+    MFnCompoundAttribute c;
+    MFnEnumAttribute e;
+    MFnMessageAttribute m;
+    MFnNumericAttribute n;
+    MFnTypedAttribute t;
+    MFnUnitAttribute u;
+    MFnStringData stringData;
+
+    aTime = u.create("time", "tm", MFnUnitAttribute::kTime, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+
+    aInput = u.create("input", "i", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+    u.setArray(true);
+
+    aCacheMode = e.create("cacheMode", "cm", CACHE_MODE_LIVE, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(e);
+
+    e.addField("Live", CACHE_MODE_LIVE);
+    e.addField("Cached", CACHE_MODE_CACHED);
+
+    aCacheFile = t.create("cacheFile", "cf", MFnData::kString, stringData.create(""), &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(t);
+    t.setKeyable(false);
+    t.setUsedAsFilename(true);
+
+    aStashedNode = m.create("stashedNode", "stn", &status);
+    __CHECK_STATUS(status);
+
+    aStashedAttribute = t.create("stashedAttribute", "sta", MFnData::kString, stringData.create(""), &status);
+    __CHECK_STATUS(status);
+
+    aStashedInput = c.create("stashedInput", "sti", &status);
+    __CHECK_STATUS(status);
+    c.addChild(aStashedNode);
+    c.addChild(aStashedAttribute);
+    c.setArray(true);
+    c.setStorable(true);
+    c.setHidden(true);
+
+    aOutput = u.create("output", "o", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_OUTPUT_ATTR(u);
+    u.setArray(true);
+    u.setUsesArrayDataBuilder(true);
+
+    aStale = n.create("stale", "stl", MFnNumericData::kBoolean, false, &status);
+    __CHECK_STATUS(status);
+    MAKE_OUTPUT_ATTR(n);
+
+    addAttribute(aTime);
+    addAttribute(aInput);
+    addAttribute(aCacheMode);
+    addAttribute(aCacheFile);
+    addAttribute(aStashedInput);
+    addAttribute(aOutput);
+    addAttribute(aStale);
+
+    attributeAffects(aTime, aOutput);
+    attributeAffects(aInput, aOutput);
+    attributeAffects(aCacheMode, aOutput);
+    attributeAffects(aCacheFile, aOutput);
+
+    attributeAffects(aTime, aStale);
+    attributeAffects(aInput, aStale);
+    attributeAffects(aCacheFile, aStale);
+    attributeAffects(aStashedInput, aStale);
+
+    return MS::kSuccess;
+}
+
+// Identifies a node in a way that survives renaming and reopening the scene.
+static MString nodeId(const MObject& node)
+{
+    MFnDependencyNode fnNode(node);
+
+#if MAYA_API_VERSION >= 201600
+    return fnNode.uuid().asString();
+#else
+    return fnNode.name();
+#endif
+}
+
+MString AngleCacheNode::attributePath(const MPlug& plug)
+{
+    return plug.partialName(false, false, false, false, true, true);
+}
+
+bool AngleCacheNode::stashedSource(const MPlug& element, MObject& node, MString& attribute)
+{
+    MPlugArray sources;
+    element.child(aStashedNode).connectedTo(sources, true, false);
+
+    attribute = element.child(aStashedAttribute).asString();
+
+    if (sources.length() == 0 || attribute.length() == 0)
+    {
+        return false;
+    }
+
+    node = sources[0].node();
+
+    return true;
+}
+
+// FNV-1a hash of the logical index and source of every input, where the 
+// source is the connected plug or else the stashed one.
+uint64_t AngleCacheNode::upstreamSignature() const
+{
+    std::map<unsigned, MString> sources;
+
+    MPlug inputPlug(thisMObject(), aInput);
+    MPlug stashPlug(thisMObject(), aStashedInput);
+
+    for (unsigned i = 0; i < inputPlug.numElements(); i++)
+    {
+        MPlug element = inputPlug.elementByPhysicalIndex(i);
+
+        MPlugArray connections;
+        element.connectedTo(connections, true, false);
+
+        MString& source = sources[element.logicalIndex()];
+
+        if (connections.length() > 0)
+        {
+            source = nodeId(connections[0].node()) + "." + attributePath(connections[0]);
+        }
+    }
+
+    for (unsigned i = 0; i < stashPlug.numElements(); i++)
+    {
+        MPlug element = stashPlug.elementByPhysicalIndex(i);
+
+        MObject node;
+        MString attribute;
+
+        MString& source = sources[element.logicalIndex()];
+
+        if (source.length() == 0 && stashedSource(element, node, attribute))
+        {
+            source = nodeId(node) + "." + attribute;
+        }
+    }
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    for (std::map<unsigned, MString>::const_iterator it = sources.begin(); it != sources.end(); it++)
+    {
+        unsigned index = it->first;
+
+        for (unsigned b = 0; b < sizeof(index); b++)
+        {
+            hash = (hash ^ ((index >> (b * 8)) & 0xff)) * FNV_PRIME;
+        }
+
+        for (const char* c = it->second.asChar(); *c != '\0'; c++)
+        {
+            hash = (hash ^ (unsigned char) *c) * FNV_PRIME;
+        }
+
+        // Separates the entries so that they cannot run together.
+        hash = (hash ^ 0xff) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+// FNV-1a hash of the values rounded to the stale tolerance, so that values
+// sampled again from an unchanged network give the same checksum.
+uint64_t AngleCacheNode::valuesChecksum(const std::vector<double>& values)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        long long rounded = llround(values[i] / STALE_TOLERANCE);
+
+        for (unsigned b = 0; b < sizeof(rounded); b++)
+        {
+            hash = (hash ^ (((unsigned long long) rounded >> (b * 8)) & 0xff)) * FNV_PRIME;
+        }
+    }
+
+    return hash;
+}
+
+void AngleCacheNode::releaseCache()
+{
+    file_.close();
+
+    loadedPath_ = MString();
+    isLoaded_ = false;
+    header_ = NULL;
+    indices_ = NULL;
+    values_ = NULL;
+}
+
+MStatus AngleCacheNode::writeCache(
+    const MString& path,
+    const AngleCacheHeader& header,
+    const std::vector<uint32_t>& indices,
+    const std::vector<double>& values
+) {
+    // The file is never rewritten in place, as truncating a mapped file would
+    // fault on the next read. The new file is written beside it and moved over
+    // it in one step.
+    MString tempPath = path + ".tmp";
+
+    {
+        std::ofstream file(tempPath.asChar(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!file)
+        {
+            return MS::kFailure;
+        }
+
+        const char padding[8] = { 0 };
+        size_t indicesSize = indices.size() * sizeof(uint32_t);
+
+        file.write((const char*) &header, sizeof(AngleCacheHeader));
+        file.write((const char*) indices.data(), indicesSize);
+        file.write(padding, (8 - indicesSize % 8) % 8);
+        file.write((const char*) values.data(), values.size() * sizeof(double));
+        file.close();
+
+        if (!file)
+        {
+            remove(tempPath.asChar());
+            return MS::kFailure;
+        }
+    }
+
+    if (!replaceFile(tempPath.asChar(), path.asChar()))
+    {
+        remove(tempPath.asChar());
+        return MS::kFailure;
+    }
+
+    return MS::kSuccess;
+}
+
+// Returns true if the data holds a complete cache file of this version.
+static bool isValidCache(const char* data, size_t size)
+{
+    if (data == NULL || size < sizeof(AngleCacheHeader))
+    {
+        return false;
+    }
+
+    const AngleCacheHeader* header = (const AngleCacheHeader*) data;
+
+    size_t indicesSize = header->channelCount * sizeof(uint32_t);
+    size_t valuesOffset = sizeof(AngleCacheHeader) + indicesSize + (8 - indicesSize % 8) % 8;
+    size_t valuesSize = (size_t) header->channelCount * header->frameCount * sizeof(double);
+
+    return (
+        memcmp(header->magic, ANGLE_CACHE_MAGIC, sizeof(ANGLE_CACHE_MAGIC)) == 0
+        && header->version == ANGLE_CACHE_VERSION
+        && header->frameCount > 0
+        && header->frameSeconds > 0.0
+        && size >= valuesOffset + valuesSize
+    );
+}
+
+bool AngleCacheNode::readCacheLayout(const MString& path, AngleCacheHeader& header, std::vector<uint32_t>& indices)
+{
+    std::ifstream file(path.asChar(), std::ios::in | std::ios::binary);
+
+    if (!file.read((char*) &header, sizeof(AngleCacheHeader)))
+    {
+        return false;
+    }
+
+    bool isValid = (
+        memcmp(header.magic, ANGLE_CACHE_MAGIC, sizeof(ANGLE_CACHE_MAGIC)) == 0
+        && header.version == ANGLE_CACHE_VERSION
+        && header.frameCount > 0
+        && header.frameSeconds > 0.0
+    );
+
+    if (!isValid)
+    {
+        return false;
+    }
+
+    indices.resize(header.channelCount);
+
+    return header.channelCount == 0 || (bool) file.read((char*) indices.data(), header.channelCount * sizeof(uint32_t));
+}
+
+bool AngleCacheNode::loadCache(const MString& path)
+{
+    this->releaseCache();
+    loadedPath_ = path;
+
+    if (path.length() == 0 || !file_.open(path.asChar()))
+    {
+        return false;
+    }
+
+    const char* data = file_.data();
+
+    if (!isValidCache(data, file_.size()))
+    {
+        file_.close();
+        return false;
+    }
+
+    const AngleCacheHeader* header = (const AngleCacheHeader*) data;
+    size_t indicesSize = header->channelCount * sizeof(uint32_t);
+
+    header_ = header;
+    indices_ = (const uint32_t*) (data + sizeof(AngleCacheHeader));
+    values_ = (const double*) (data + sizeof(AngleCacheHeader) + indicesSize + (8 - indicesSize % 8) % 8);
+    isLoaded_ = true;
+
+    return true;
+}
+
+// Makes sure the loaded cache is the file at the path. The file is only
+// loaded again when the path changes or after releaseCache(), so playback
+// never touches the file system.
+bool AngleCacheNode::updateCache(const MString& path)
+{
+    if (path != loadedPath_)
+    {
+        this->loadCache(path);
+    }
+
+    return isLoaded_;
+}
+
+// Returns the nearest cached frame to the given time, clamped to the cached
+// range. Returns false if the time is outside the range.
+bool AngleCacheNode::frameIndex(double seconds, uint32_t& index) const
+{
+    double frame = floor((seconds - header_->startSeconds) / header_->frameSeconds + 0.5);
+    double lastFrame = (double) (header_->frameCount - 1);
+
+    index = (uint32_t) (frame < 0.0 ? 0.0 : (frame > lastFrame ? lastFrame : frame));
+
+    return frame >= 0.0 && frame <= lastFrame;
+}
+
+MStatus AngleCacheNode::compute(const MPlug& plug, MDataBlock& data)
+{
+    MPlug outputPlug = plug.isElement() ? plug.array() : plug;
+
+    if (outputPlug == aOutput)
+    {
+        return this->computeOutput(data);
+    }
+
+    if (outputPlug == aStale)
+    {
+        return this->computeStale(data);
+    }
+
+    return MS::kUnknownParameter;
+}
+
+MStatus AngleCacheNode::computeOutput(MDataBlock& data)
+{
+    MStatus status;
+
+    short cacheMode = data.inputValue(aCacheMode).asShort();
+    MArrayDataHandle outputArrayHandle = data.outputArrayValue(aOutput);
+
+    if (cacheMode == CACHE_MODE_CACHED)
+    {
+        MString path = data.inputValue(aCacheFile).asString();
+
+        if (this->updateCache(path))
+        {
+            double seconds = data.inputValue(aTime).asTime().as(MTime::kSeconds);
+
+            uint32_t frame;
+            this->frameIndex(seconds, frame);
+
+            uint32_t frameCount = header_->frameCount;
+            uint32_t channelCount = header_->channelCount;
+
+            MArrayDataBuilder builder(&data, aOutput, channelCount, &status);
+            __CHECK_STATUS(status);
+
+            for (uint32_t c = 0; c < channelCount; c++)
+            {
+                double value = values_[(size_t) c * frameCount + frame];
+
+                MDataHandle output = builder.addElement(indices_[c]);
+                output.setMAngle(MAngle(value, MAngle::kDegrees));
+            }
+
+            outputArrayHandle.set(builder);
+            outputArrayHandle.setAllClean();
+
+            return MS::kSuccess;
+        }
+    }
+
+    MArrayDataHandle inputArrayHandle = data.inputArrayValue(aInput);
+    unsigned numInputs = inputArrayHandle.elementCount();
+
+    MArrayDataBuilder builder(&data, aOutput, numInputs, &status);
+    __CHECK_STATUS(status);
+
+    for (unsigned i = 0; i < numInputs; i++)
+    {
+        MDataHandle output = builder.addElement(inputArrayHandle.elementIndex());
+        output.setMAngle(inputArrayHandle.inputValue().asAngle());
+        inputArrayHandle.next();
+    }
+
+    outputArrayHandle.set(builder);
+    outputArrayHandle.setAllClean();
+
+    return MS::kSuccess;
+}
+
+MStatus AngleCacheNode::computeStale(MDataBlock& data)
+{
+    MString path = data.inputValue(aCacheFile).asString();
+
+    bool isStale = !this->updateCache(path);
+
+    if (!isStale)
+    {
+        isStale = header_->signature != this->upstreamSignature();
+    }
+
+    if (!isStale)
+    {
+        MArrayDataHandle inputArrayHandle = data.inputArrayValue(aInput);
+        unsigned numInputs = inputArrayHandle.elementCount();
+
+        double seconds = data.inputValue(aTime).asTime().as(MTime::kSeconds);
+
+        // Stashed inputs are disconnected and only hold their last value, so
+        // they are checked by the signature alone.
+        MIntArray stashedIndices;
+        MPlug(thisMObject(), aStashedInput).getExistingArrayAttributeIndices(stashedIndices);
+
+        uint32_t frame;
+        isStale = !this->frameIndex(seconds, frame) || numInputs != header_->channelCount;
+
+        for (unsigned c = 0; c < numInputs && !isStale; c++)
+        {
+            unsigned index = inputArrayHandle.elementIndex();
+            bool isStashed = false;
+
+            for (unsigned s = 0; s < stashedIndices.length() && !isStashed; s++)
+            {
+                isStashed = (unsigned) stashedIndices[s] == index;
+            }
+
+            double live = inputArrayHandle.inputValue().asAngle().asDegrees();
+            double cached = values_[(size_t) c * header_->frameCount + frame];
+
+            isStale = index != indices_[c] || (!isStashed && fabs(live - cached) > STALE_TOLERANCE);
+            inputArrayHandle.next();
+        }
+    }
+
+    MDataHandle staleHandle = data.outputValue(aStale);
+    staleHandle.setBool(isStale);
+    staleHandle.setClean();
+
+    return MS::kSuccess;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef N_ANGLE_CACHE_H
+#define N_ANGLE_CACHE_H
+
+#include "mappedFile.h"
+
+#include <stdint.h>
+#include <vector>
+
+#include <maya/MDataBlock.h>
+#include <maya/MPlug.h>
+#include <maya/MPxNode.h>
+#include <maya/MString.h>
+#include <maya/MTypeId.h>
+
+const short CACHE_MODE_LIVE =       0;
+const short CACHE_MODE_CACHED =     1;
+
+const char ANGLE_CACHE_MAGIC[8] =   { 'A', 'N', 'G', 'C', 'A', 'C', 'H', 'E' };
+const uint32_t ANGLE_CACHE_VERSION = 2;
+
+// Layout of an angle cache file: this header, then channelCount uint32 
+// logical indices of the cached input elements, padded to 8 bytes, then 
+// channelCount contiguous arrays of frameCount doubles (degrees).
+struct AngleCacheHeader
+{
+    char                    magic[8];
+    uint32_t                version;
+    uint32_t                channelCount;
+    uint32_t                frameCount;
+    uint32_t                reserved;
+    double                  startSeconds;
+    double                  frameSeconds;
+    uint64_t                signature;
+    uint64_t                checksum;
+};
+
+class AngleCacheNode : public MPxNode
+{
+public:
+                            AngleCacheNode();
+
+    virtual MStatus         compute(const MPlug& plug, MDataBlock& data);
+
+    static  void*           creator();
+    static  MStatus         initialize();
+
+    // Hash of the sources of the input elements, stored in the cache file so
+    // that a rewired network is detected as stale.
+    uint64_t                upstreamSignature() const;
+
+    // Hash of baked values, rounded to the stale tolerance, stored in the 
+    // cache file so that bakeAngleCache -check can detect upstream edits.
+    static uint64_t         valuesChecksum(const std::vector<double>& values);
+
+    // Reads the header and input indices of a cache file. Returns false if
+    // it is missing or not a cache file of this version.
+    static bool             readCacheLayout(const MString& path, AngleCacheHeader& header, std::vector<uint32_t>& indices);
+
+    // Returns the attribute of a plug as it is stored in Stashed Attribute.
+    static MString          attributePath(const MPlug& plug);
+
+    // Gets the source stashed in an element of Stashed Input. Returns false
+    // if the element holds no source.
+    static bool             stashedSource(const MPlug& element, MObject& node, MString& attribute);
+
+    // Unmaps the cache file so that it can be overwritten.
+    void                    releaseCache();
+
+    static MStatus          writeCache(
+                                const MString& path, 
+                                const AngleCacheHeader& header, 
+                                const std::vector<uint32_t>& indices, 
+                                const std::vector<double>& values
+                            );
+
+public:
+    static MTypeId          kNODE_ID;
+    static MString          kNODE_NAME;
+
+    static MObject          aTime;
+    static MObject          aInput;
+    static MObject          aCacheMode;
+    static MObject          aCacheFile;
+    static MObject          aStashedInput;
+    static MObject          aStashedNode;
+    static MObject          aStashedAttribute;
+    static MObject          aOutput;
+    static MObject          aStale;
+
+private:
+    bool                    loadCache(const MString& path);
+    bool                    updateCache(const MString& path);
+    bool                    frameIndex(double seconds, uint32_t& index) const;
+    MStatus                 computeOutput(MDataBlock& data);
+    MStatus                 computeStale(MDataBlock& data);
+
+private:
+    MappedFile              file_;
+    MString                 loadedPath_;
+    bool                    isLoaded_;
+
+    const AngleCacheHeader* header_;
+    const uint32_t*         indices_;
+    const double*           values_;
+};
+
+#endif
\ No newline at end of file
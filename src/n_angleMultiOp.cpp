@@ -13,34 +13,32 @@ You may use, distribute, or modify this code under the terms of the MIT license.
 //      Product         - Returns the product of the input values.
 //      Minimum         - Returns the smallest input value.
 //      Maximum         - Returns the largest input value.
+//
+//  Inputs are reduced in fixed chunks, which are spread across threads once
+//  there are at least Parallel Threshold inputs.
 //-----------------------------------------------------------------------------
 
 #include "n_angleMultiOp.h"
 #include "node.h"
+#include "parallel.h"
+#include "reduce.h"
 
 #include <vector>
-#include <algorithm>
-#include <numeric>
 
 #include <maya/MAngle.h>
 #include <maya/MDataHandle.h>
 #include <maya/MFnEnumAttribute.h>
 #include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
 #include <maya/MFnUnitAttribute.h>
 #include <maya/MPlug.h>
 #include <maya/MPxNode.h>
 
 MObject AngleMultiOpNode::aInput;
 MObject AngleMultiOpNode::aOperation;
+MObject AngleMultiOpNode::aParallelThreshold;
 MObject AngleMultiOpNode::aOutput;
 
-const short NO_OP = 0;
-const short SUM = 1;
-const short DIFF = 2;
-const short PRODUCT = 3;
-const short MIN_ = 4;
-const short MAX_ = 5;
-
 void* AngleMultiOpNode::creator()
 {
     return new AngleMultiOpNode();
@@ -52,6 +50,7 @@ MStatus AngleMultiOpNode::initialize()
 
     MFnUnitAttribute u;
     MFnEnumAttribute e;
+    MFnNumericAttribute n;
 
     aInput = u.create("input", "i", MFnUnitAttribute::kAngle, 0.0, &status);
     __CHECK_STATUS(status);
@@ -69,16 +68,24 @@ MStatus AngleMultiOpNode::initialize()
     e.addField("Minimum", MIN_);
     e.addField("Maximum", MAX_);
 
+    aParallelThreshold = n.create("parallelThreshold", "pth", MFnNumericData::kInt, DEFAULT_PARALLEL_THRESHOLD, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+    n.setKeyable(false);
+    n.setMin(0);
+
     aOutput = u.create("output", "o", MFnUnitAttribute::kAngle, 0.0, &status);
     __CHECK_STATUS(status);
     MAKE_OUTPUT_ATTR(u)
 
     addAttribute(aInput);
     addAttribute(aOperation);
+    addAttribute(aParallelThreshold);
     addAttribute(aOutput);
 
     attributeAffects(aInput, aOutput);
     attributeAffects(aOperation, aOutput);
+    attributeAffects(aParallelThreshold, aOutput);
 
     return MS::kSuccess;
 }
@@ -102,31 +109,9 @@ MStatus AngleMultiOpNode::compute(const MPlug& plug, MDataBlock& data)
     }
 
     short operation = data.inputValue(aOperation).asShort();
+    int parallelThreshold = data.inputValue(aParallelThreshold).asInt();
 
-    double result = 0;
-
-    switch (operation)
-    {
-        case SUM:
-            result = std::accumulate(inputs.begin(), inputs.end(), 0.0, std::plus<double>());
-            break;
-
-        case DIFF:
-            result = std::accumulate(inputs.begin(), inputs.end(), 0.0, std::minus<double>());
-            break;
-
-        case PRODUCT:
-            result = std::accumulate(inputs.begin(), inputs.end(), 1.0, std::multiplies<double>());
-            break;
-
-        case MIN_:
-            result = *std::min_element(inputs.begin(), inputs.end());
-            break;
-
-        case MAX_:
-            result = *std::max_element(inputs.begin(), inputs.end());
-            break;
-    }
+    double result = reduceAnglesChunked(operation, inputs.data(), numInputs, (unsigned) parallelThreshold);
 
     MDataHandle output = data.outputValue(aOutput);
     output.setMAngle(MAngle(result, MAngle::kDegrees));
@@ -20,6 +20,7 @@ public:
 
     static MObject          aInput;
     static MObject          aOperation;
+    static MObject          aParallelThreshold;
     static MObject          aOutput;
 };
 
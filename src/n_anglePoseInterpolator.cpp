@@ -0,0 +1,392 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+//-----------------------------------------------------------------------------
+//  anglePoseInterpolator node
+//
+//  Outputs a weight for each stored pose based on how close the input angles
+//  are to that pose, using Gaussian radial basis function interpolation. Each
+//  weight is 1.0 at its own pose and 0.0 at every other pose.
+//      Input Rotate    - Rotate angles compared against each pose rotate.
+//      Input           - Additional angles compared against the pose input
+//                        with the same index; missing pose inputs are 0.0.
+//      Radius          - Distance between angles at which the kernel falls
+//                        off to 1/e.
+//      Regularization  - Added to the diagonal of the kernel matrix; higher
+//                        values give smoother, less exact interpolation.
+//
+//  Differences between angles are wrapped to [-180, 180) degrees. The kernel
+//  matrix is factorized and inverted only when the poses, radius or
+//  regularization change, so each evaluation is a single matrix-vector
+//  product.
+//-----------------------------------------------------------------------------
+
+#define NOMINMAX
+#define _USE_MATH_DEFINES
+
+#include "n_anglePoseInterpolator.h"
+#include "node.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+#include <maya/MAngle.h>
+#include <maya/MArrayDataBuilder.h>
+#include <maya/MArrayDataHandle.h>
+#include <maya/MDataHandle.h>
+#include <maya/MFnCompoundAttribute.h>
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
+#include <maya/MFnUnitAttribute.h>
+#include <maya/MGlobal.h>
+#include <maya/MPlug.h>
+#include <maya/MPxNode.h>
+
+MObject AnglePoseInterpolatorNode::aInputRotate;
+MObject AnglePoseInterpolatorNode::aInputRotateX;
+MObject AnglePoseInterpolatorNode::aInputRotateY;
+MObject AnglePoseInterpolatorNode::aInputRotateZ;
+MObject AnglePoseInterpolatorNode::aInput;
+
+MObject AnglePoseInterpolatorNode::aPose;
+MObject AnglePoseInterpolatorNode::aPoseRotate;
+MObject AnglePoseInterpolatorNode::aPoseRotateX;
+MObject AnglePoseInterpolatorNode::aPoseRotateY;
+MObject AnglePoseInterpolatorNode::aPoseRotateZ;
+MObject AnglePoseInterpolatorNode::aPoseInput;
+
+MObject AnglePoseInterpolatorNode::aRadius;
+MObject AnglePoseInterpolatorNode::aRegularization;
+
+MObject AnglePoseInterpolatorNode::aOutputWeight;
+
+const double SINGULAR_PIVOT = 1e-12;
+
+AnglePoseInterpolatorNode::AnglePoseInterpolatorNode() :
+    isSolved_(false),
+    hasWarned_(false),
+    solvedRadius_(0.0),
+    solvedRegularization_(0.0),
+    solvedDimension_(0)
+{
+}
+
+void* AnglePoseInterpolatorNode::creator()
+{
+    return new AnglePoseInterpolatorNode();
+}
+
+MStatus AnglePoseInterpolatorNode::initialize()
+{
+    MStatus status;
+
+    MFnCompoundAttribute c;
+    MFnNumericAttribute n;
+    MFnUnitAttribute u;
+
+    aInputRotateX = u.create("inputRotateX", "irx", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    aInputRotateY = u.create("inputRotateY", "iry", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    aInputRotateZ = u.create("inputRotateZ", "irz", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+
+    aInputRotate = n.create("inputRotate", "ir", aInputRotateX, aInputRotateY, aInputRotateZ, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+
+    aInput = u.create("input", "i", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+    u.setArray(true);
+
+    aPoseRotateX = u.create("poseRotateX", "prx", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    aPoseRotateY = u.create("poseRotateY", "pry", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    aPoseRotateZ = u.create("poseRotateZ", "prz", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+
+    aPoseRotate = n.create("poseRotate", "pr", aPoseRotateX, aPoseRotateY, aPoseRotateZ, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+
+    aPoseInput = u.create("poseInput", "pi", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+    u.setArray(true);
+
+    aPose = c.create("pose", "p", &status);
+    __CHECK_STATUS(status);
+    c.addChild(aPoseRotate);
+    c.addChild(aPoseInput);
+    MAKE_INPUT_ATTR(c);
+    c.setArray(true);
+
+    aRadius = u.create("radius", "rad", MFnUnitAttribute::kAngle, M_PI / 4.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+    u.setMin(1e-4);
+
+    aRegularization = n.create("regularization", "reg", MFnNumericData::kDouble, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+    n.setMin(0.0);
+    n.setSoftMax(1.0);
+
+    aOutputWeight = n.create("outputWeight", "ow", MFnNumericData::kDouble, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_OUTPUT_ATTR(n);
+    n.setArray(true);
+    n.setUsesArrayDataBuilder(true);
+
+    addAttribute(aInputRotate);
+    addAttribute(aInput);
+    addAttribute(aPose);
+    addAttribute(aRadius);
+    addAttribute(aRegularization);
+    addAttribute(aOutputWeight);
+
+    attributeAffects(aInputRotate, aOutputWeight);
+    attributeAffects(aInput, aOutputWeight);
+    attributeAffects(aPose, aOutputWeight);
+    attributeAffects(aRadius, aOutputWeight);
+    attributeAffects(aRegularization, aOutputWeight);
+
+    return MS::kSuccess;
+}
+
+// Gaussian kernel of the wrapped distance between two angle vectors.
+static double kernel(const double* a, const double* b, unsigned dimension, double radius)
+{
+    double distanceSquared = 0.0;
+
+    for (unsigned i = 0; i < dimension; i++)
+    {
+        double delta = wrapAngle(a[i] - b[i]);
+        distanceSquared += delta * delta;
+    }
+
+    return exp(-distanceSquared / (radius * radius));
+}
+
+// Builds the kernel matrix for the current poses and stores its inverse. The
+// matrix is LU factorized with partial pivoting and the inverse is solved for
+// one column at a time. Returns false if the matrix is singular, which
+// happens when two poses are identical and there is no regularization.
+bool AnglePoseInterpolatorNode::solve()
+{
+    unsigned numPoses = (unsigned) poseIndices_.size();
+    unsigned dimension = (unsigned) driver_.size();
+
+    std::vector<double> lu(numPoses * numPoses);
+    std::vector<unsigned> pivots(numPoses);
+
+    for (unsigned i = 0; i < numPoses; i++)
+    {
+        for (unsigned j = 0; j < numPoses; j++)
+        {
+            lu[i * numPoses + j] = kernel(&poses_[i * dimension], &poses_[j * dimension], dimension, solvedRadius_);
+        }
+
+        lu[i * numPoses + i] += solvedRegularization_;
+    }
+
+    for (unsigned k = 0; k < numPoses; k++)
+    {
+        unsigned pivot = k;
+
+        for (unsigned i = k + 1; i < numPoses; i++)
+        {
+            if (fabs(lu[i * numPoses + k]) > fabs(lu[pivot * numPoses + k])) pivot = i;
+        }
+
+        if (fabs(lu[pivot * numPoses + k]) < SINGULAR_PIVOT)
+        {
+            return false;
+        }
+
+        pivots[k] = pivot;
+
+        if (pivot != k)
+        {
+            std::swap_ranges(lu.begin() + k * numPoses, lu.begin() + (k + 1) * numPoses, lu.begin() + pivot * numPoses);
+        }
+
+        for (unsigned i = k + 1; i < numPoses; i++)
+        {
+            double factor = lu[i * numPoses + k] / lu[k * numPoses + k];
+            lu[i * numPoses + k] = factor;
+
+            for (unsigned j = k + 1; j < numPoses; j++)
+            {
+                lu[i * numPoses + j] -= factor * lu[k * numPoses + j];
+            }
+        }
+    }
+
+    // Solve LU x = P e_c for each column c of the identity. The inverse is
+    // stored row-major, so inverse_[i * numPoses + c] is row i of column c.
+    inverse_.assign(numPoses * numPoses, 0.0);
+    std::vector<double> column(numPoses);
+
+    for (unsigned c = 0; c < numPoses; c++)
+    {
+        std::fill(column.begin(), column.end(), 0.0);
+        column[c] = 1.0;
+
+        for (unsigned k = 0; k < numPoses; k++)
+        {
+            std::swap(column[k], column[pivots[k]]);
+        }
+
+        for (unsigned i = 0; i < numPoses; i++)
+        {
+            for (unsigned j = 0; j < i; j++) column[i] -= lu[i * numPoses + j] * column[j];
+        }
+
+        for (unsigned i = numPoses; i-- > 0;)
+        {
+            for (unsigned j = i + 1; j < numPoses; j++) column[i] -= lu[i * numPoses + j] * column[j];
+            column[i] /= lu[i * numPoses + i];
+        }
+
+        for (unsigned i = 0; i < numPoses; i++)
+        {
+            inverse_[i * numPoses + c] = column[i];
+        }
+    }
+
+    return true;
+}
+
+MStatus AnglePoseInterpolatorNode::compute(const MPlug& plug, MDataBlock& data)
+{
+    MPlug outputPlug = plug.isElement() ? plug.array() : plug;
+
+    if (outputPlug != aOutputWeight)
+    {
+        return MS::kUnknownParameter;
+    }
+
+    MStatus status;
+
+    MDataHandle inputRotateHandle = data.inputValue(aInputRotate);
+    MArrayDataHandle inputArrayHandle = data.inputArrayValue(aInput);
+    MArrayDataHandle poseArrayHandle = data.inputArrayValue(aPose);
+
+    double radius = data.inputValue(aRadius).asAngle().asDegrees();
+    double regularization = data.inputValue(aRegularization).asDouble();
+
+    unsigned numInputs = inputArrayHandle.elementCount();
+    unsigned numPoses = poseArrayHandle.elementCount();
+    unsigned dimension = 3 + numInputs;
+
+    driver_.resize(dimension);
+    driver_[0] = inputRotateHandle.child(aInputRotateX).asAngle().asDegrees();
+    driver_[1] = inputRotateHandle.child(aInputRotateY).asAngle().asDegrees();
+    driver_[2] = inputRotateHandle.child(aInputRotateZ).asAngle().asDegrees();
+
+    inputIndices_.resize(numInputs);
+
+    for (unsigned i = 0; i < numInputs; i++)
+    {
+        driver_[3 + i] = inputArrayHandle.inputValue().asAngle().asDegrees();
+        inputIndices_[i] = inputArrayHandle.elementIndex();
+        inputArrayHandle.next();
+    }
+
+    // Pose inputs are matched to the driver inputs by logical index; missing
+    // pose inputs are zero.
+    poses_.assign(numPoses * dimension, 0.0);
+    poseIndices_.resize(numPoses);
+
+    for (unsigned p = 0; p < numPoses; p++)
+    {
+        double* pose = &poses_[p * dimension];
+
+        MDataHandle poseHandle = poseArrayHandle.inputValue();
+        MDataHandle poseRotateHandle = poseHandle.child(aPoseRotate);
+        MArrayDataHandle poseInputArrayHandle(poseHandle.child(aPoseInput));
+
+        pose[0] = poseRotateHandle.child(aPoseRotateX).asAngle().asDegrees();
+        pose[1] = poseRotateHandle.child(aPoseRotateY).asAngle().asDegrees();
+        pose[2] = poseRotateHandle.child(aPoseRotateZ).asAngle().asDegrees();
+
+        unsigned numPoseInputs = poseInputArrayHandle.elementCount();
+
+        for (unsigned i = 0; i < numInputs && numPoseInputs > 0; i++)
+        {
+            if (poseInputArrayHandle.jumpToElement(inputIndices_[i]))
+            {
+                pose[3 + i] = poseInputArrayHandle.inputValue().asAngle().asDegrees();
+            }
+        }
+
+        poseIndices_[p] = poseArrayHandle.elementIndex();
+        poseArrayHandle.next();
+    }
+
+    bool posesChanged = (
+        poses_ != solvedPoses_
+        || dimension != solvedDimension_
+        || radius != solvedRadius_
+        || regularization != solvedRegularization_
+    );
+
+    if (posesChanged)
+    {
+        solvedPoses_ = poses_;
+        solvedDimension_ = dimension;
+        solvedRadius_ = radius;
+        solvedRegularization_ = regularization;
+
+        isSolved_ = this->solve() || numPoses == 0;
+
+        // Warns once when the poses become degenerate rather than on every
+        // edit, which would flood the script editor while poses are animated.
+        if (!isSolved_ && !hasWarned_)
+        {
+            MGlobal::displayWarning(
+                kNODE_NAME + ": poses are not distinct; increase the regularization or remove duplicate poses."
+            );
+        }
+
+        hasWarned_ = !isSolved_;
+    }
+
+    kernel_.resize(numPoses);
+
+    for (unsigned p = 0; p < numPoses; p++)
+    {
+        kernel_[p] = kernel(driver_.data(), &poses_[p * dimension], dimension, radius);
+    }
+
+    MArrayDataHandle outputArrayHandle = data.outputArrayValue(aOutputWeight);
+    MArrayDataBuilder builder(&data, aOutputWeight, numPoses, &status);
+    __CHECK_STATUS(status);
+
+    for (unsigned c = 0; c < numPoses; c++)
+    {
+        double weight = 0.0;
+
+        if (isSolved_)
+        {
+            for (unsigned p = 0; p < numPoses; p++)
+            {
+                weight += kernel_[p] * inverse_[p * numPoses + c];
+            }
+        }
+
+        MDataHandle output = builder.addElement(poseIndices_[c]);
+        output.setDouble(weight);
+    }
+
+    outputArrayHandle.set(builder);
+    outputArrayHandle.setAllClean();
+
+    return MS::kSuccess;
+}
\ No newline at end of file
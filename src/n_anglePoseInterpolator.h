@@ -0,0 +1,63 @@
+#ifndef N_ANGLE_POSE_INTERPOLATOR_H
+#define N_ANGLE_POSE_INTERPOLATOR_H
+
+#include <vector>
+
+#include <maya/MDataBlock.h>
+#include <maya/MPlug.h>
+#include <maya/MPxNode.h>
+#include <maya/MString.h>
+#include <maya/MTypeId.h>
+
+class AnglePoseInterpolatorNode : public MPxNode
+{
+public:
+                            AnglePoseInterpolatorNode();
+
+    virtual MStatus         compute(const MPlug& plug, MDataBlock& data);
+    static  void*           creator();
+    static  MStatus         initialize();
+
+public:
+    static MTypeId          kNODE_ID;
+    static MString          kNODE_NAME;
+
+    static MObject          aInputRotate;
+    static MObject          aInputRotateX;
+    static MObject          aInputRotateY;
+    static MObject          aInputRotateZ;
+    static MObject          aInput;
+
+    static MObject          aPose;
+    static MObject          aPoseRotate;
+    static MObject          aPoseRotateX;
+    static MObject          aPoseRotateY;
+    static MObject          aPoseRotateZ;
+    static MObject          aPoseInput;
+
+    static MObject          aRadius;
+    static MObject          aRegularization;
+
+    static MObject          aOutputWeight;
+
+private:
+    bool                    solve();
+
+private:
+    bool                    isSolved_;
+    bool                    hasWarned_;
+    double                  solvedRadius_;
+    double                  solvedRegularization_;
+    unsigned                solvedDimension_;
+
+    std::vector<double>     driver_;
+    std::vector<double>     poses_;
+    std::vector<double>     solvedPoses_;
+    std::vector<unsigned>   inputIndices_;
+    std::vector<unsigned>   poseIndices_;
+
+    std::vector<double>     inverse_;
+    std::vector<double>     kernel_;
+};
+
+#endif
\ No newline at end of file
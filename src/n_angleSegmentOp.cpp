@@ -0,0 +1,215 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+//-----------------------------------------------------------------------------
+//  angleSegmentOp node
+//
+//  Performs a reducing operation on each segment of a flat array of input 
+//  values, writing one output value per segment. Segment N starts at the 
+//  input index given by segmentOffset[N] and ends where the next segment 
+//  starts, and its result is written to output[N]. Indices are logical, so 
+//  sparse inputs and segments are allowed; a segment includes the inputs 
+//  that exist within its range.
+//      No Operation    - Returns zero.
+//      Sum             - Returns the sum of the segment values.
+//      Difference      - Returns the difference of the segment values. 
+//      Product         - Returns the product of the segment values.
+//      Minimum         - Returns the smallest segment value.
+//      Maximum         - Returns the largest segment value.
+//
+//  Segments are spread across threads once there are at least Parallel 
+//  Threshold inputs. Each segment is always reduced on a single thread, so
+//  the results do not depend on the number of threads.
+//-----------------------------------------------------------------------------
+
+#define NOMINMAX
+
+#include "n_angleSegmentOp.h"
+#include "node.h"
+#include "parallel.h"
+#include "reduce.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <maya/MAngle.h>
+#include <maya/MArrayDataBuilder.h>
+#include <maya/MArrayDataHandle.h>
+#include <maya/MDataHandle.h>
+#include <maya/MFnEnumAttribute.h>
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
+#include <maya/MFnUnitAttribute.h>
+#include <maya/MPlug.h>
+#include <maya/MPxNode.h>
+
+MObject AngleSegmentOpNode::aInput;
+MObject AngleSegmentOpNode::aSegmentOffset;
+MObject AngleSegmentOpNode::aOperation;
+MObject AngleSegmentOpNode::aParallelThreshold;
+MObject AngleSegmentOpNode::aOutput;
+
+struct ReduceSegmentsData
+{
+    short           operation;
+    const double*   values;
+    const unsigned* offsets;
+    double*         results;
+};
+
+static void reduceSegments(void* data, unsigned begin, unsigned end)
+{
+    ReduceSegmentsData* d = (ReduceSegmentsData*) data;
+
+    for (unsigned i = begin; i < end; i++)
+    {
+        unsigned start = d->offsets[i];
+        d->results[i] = reduceAngles(d->operation, d->values + start, d->offsets[i + 1] - start);
+    }
+}
+
+void* AngleSegmentOpNode::creator()
+{
+    return new AngleSegmentOpNode();
+}
+
+MStatus AngleSegmentOpNode::initialize()
+{
+    MStatus status;
+
+    MFnEnumAttribute e;
+    MFnNumericAttribute n;
+    MFnUnitAttribute u;
+
+    aInput = u.create("input", "i", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+    u.setArray(true);
+
+    aSegmentOffset = n.create("segmentOffset", "so", MFnNumericData::kInt, 0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+    n.setArray(true);
+    n.setMin(0);
+
+    aOperation = e.create("operation", "op", SUM, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(e);
+
+    e.addField("No Operation", NO_OP);
+    e.addField("Sum", SUM);
+    e.addField("Difference", DIFF);
+    e.addField("Product", PRODUCT);
+    e.addField("Minimum", MIN_);
+    e.addField("Maximum", MAX_);
+
+    aParallelThreshold = n.create("parallelThreshold", "pth", MFnNumericData::kInt, DEFAULT_PARALLEL_THRESHOLD, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+    n.setKeyable(false);
+    n.setMin(0);
+
+    aOutput = u.create("output", "o", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_OUTPUT_ATTR(u);
+    u.setArray(true);
+    u.setUsesArrayDataBuilder(true);
+
+    addAttribute(aInput);
+    addAttribute(aSegmentOffset);
+    addAttribute(aOperation);
+    addAttribute(aParallelThreshold);
+    addAttribute(aOutput);
+
+    attributeAffects(aInput, aOutput);
+    attributeAffects(aSegmentOffset, aOutput);
+    attributeAffects(aOperation, aOutput);
+    attributeAffects(aParallelThreshold, aOutput);
+
+    return MS::kSuccess;
+}
+
+MStatus AngleSegmentOpNode::compute(const MPlug& plug, MDataBlock& data)
+{
+    MPlug outputPlug = plug.isElement() ? plug.array() : plug;
+
+    if (outputPlug != aOutput) 
+    {
+        return MS::kUnknownParameter;
+    }
+
+    MStatus status;
+
+    MArrayDataHandle inputArrayHandle = data.inputArrayValue(aInput);
+    MArrayDataHandle offsetArrayHandle = data.inputArrayValue(aSegmentOffset);
+
+    unsigned numInputs = inputArrayHandle.elementCount();
+    unsigned numSegments = offsetArrayHandle.elementCount();
+
+    // The buffers are members so that their storage is reused between computes.
+    inputs_.resize(numInputs);
+    inputIndices_.resize(numInputs);
+    offsets_.resize(numSegments + 1);
+    segmentIndices_.resize(numSegments);
+
+    for (unsigned i = 0; i < numInputs; i++)
+    {
+        inputs_[i] = inputArrayHandle.inputValue().asAngle().asDegrees();
+        inputIndices_[i] = inputArrayHandle.elementIndex();
+        inputArrayHandle.next();
+    }
+
+    // Each offset is a logical input index, resolved to the position of the 
+    // first existing input at or after it. Offsets are forced to be 
+    // non-decreasing, so a bad offset yields an empty segment rather than 
+    // reading out of range.
+    unsigned lastOffset = 0;
+
+    for (unsigned i = 0; i < numSegments; i++)
+    {
+        int offset = offsetArrayHandle.inputValue().asInt();
+        segmentIndices_[i] = offsetArrayHandle.elementIndex();
+        offsetArrayHandle.next();
+
+        unsigned position = (unsigned) (std::lower_bound(
+            inputIndices_.begin(), 
+            inputIndices_.end(), 
+            (unsigned) std::max(offset, 0)
+        ) - inputIndices_.begin());
+
+        lastOffset = std::max(position, lastOffset);
+        offsets_[i] = lastOffset;
+    }
+
+    offsets_[numSegments] = numInputs;
+
+    short operation = data.inputValue(aOperation).asShort();
+    int parallelThreshold = data.inputValue(aParallelThreshold).asInt();
+
+    results_.resize(numSegments);
+
+    ReduceSegmentsData reduceData;
+    reduceData.operation = operation;
+    reduceData.values = inputs_.data();
+    reduceData.offsets = offsets_.data();
+    reduceData.results = results_.data();
+
+    parallelFor(numSegments, 64, numInputs >= (unsigned) parallelThreshold, reduceSegments, &reduceData);
+
+    MArrayDataHandle outputArrayHandle = data.outputArrayValue(aOutput);
+    MArrayDataBuilder builder(&data, aOutput, numSegments, &status);
+    __CHECK_STATUS(status);
+
+    for (unsigned i = 0; i < numSegments; i++)
+    {
+        MDataHandle output = builder.addElement(segmentIndices_[i]);
+        output.setMAngle(MAngle(results_[i], MAngle::kDegrees));
+    }
+
+    outputArrayHandle.set(builder);
+    outputArrayHandle.setAllClean();
+
+    return MS::kSuccess;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef N_ANGLE_SEGMENT_OP_H
+#define N_ANGLE_SEGMENT_OP_H
+
+#include <vector>
+
+#include <maya/MDataBlock.h>
+#include <maya/MPlug.h>
+#include <maya/MPxNode.h>
+#include <maya/MString.h>
+#include <maya/MTypeId.h>
+
+class AngleSegmentOpNode : public MPxNode
+{
+public:
+    virtual MStatus         compute(const MPlug& plug, MDataBlock& data);
+    static  void*           creator();
+    static  MStatus         initialize();
+
+public:
+    static MTypeId          kNODE_ID;
+    static MString          kNODE_NAME;
+
+    static MObject          aInput;
+    static MObject          aSegmentOffset;
+    static MObject          aOperation;
+    static MObject          aParallelThreshold;
+    static MObject          aOutput;
+
+private:
+    std::vector<double>     inputs_;
+    std::vector<unsigned>   inputIndices_;
+    std::vector<unsigned>   offsets_;
+    std::vector<unsigned>   segmentIndices_;
+    std::vector<double>     results_;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,428 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+//-----------------------------------------------------------------------------
+//  angleSpring node
+//
+//  Drives each output angle towards its target angle with a damped spring.
+//      Stiffness       - Spring strength, as the square of the natural 
+//                        frequency in radians per second.
+//      Damping         - Damping ratio; 1.0 is critically damped, lower 
+//                        values overshoot and higher values lag.
+//      Substep Rate    - Number of fixed integration steps per second.
+//
+//  The spring is integrated with implicit Euler steps of a fixed size, so the
+//  result is stable for any stiffness and does not depend on the frame rate.
+//  Steps are counted from absolute time, so each frame takes exactly the 
+//  steps that end at or before it. The spring state is reset to the targets 
+//  at or before the start frame, or when time moves backwards.
+//
+//  The spring state only advances during normal evaluation. Other contexts,
+//  such as getAttr -time or ghosting, return the current state unchanged.
+//
+//  The single angle, the rotate compound and each element of the target array
+//  are independent springs that share the same settings. Target array springs
+//  are tracked by logical index. The springs are spread across threads once 
+//  there are at least Parallel Threshold of them.
+//-----------------------------------------------------------------------------
+
+#define NOMINMAX
+
+#include "n_angleSpring.h"
+#include "node.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+#include <maya/MAngle.h>
+#include <maya/MArrayDataBuilder.h>
+#include <maya/MArrayDataHandle.h>
+#include <maya/MDGContext.h>
+#include <maya/MDataHandle.h>
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnNumericData.h>
+#include <maya/MFnUnitAttribute.h>
+#include <maya/MPlug.h>
+#include <maya/MPxNode.h>
+#include <maya/MTime.h>
+
+MObject AngleSpringNode::aTime;
+MObject AngleSpringNode::aStartFrame;
+MObject AngleSpringNode::aStiffness;
+MObject AngleSpringNode::aDamping;
+MObject AngleSpringNode::aSubstepRate;
+MObject AngleSpringNode::aParallelThreshold;
+
+MObject AngleSpringNode::aTarget;
+MObject AngleSpringNode::aTargetRotate;
+MObject AngleSpringNode::aTargetRotateX;
+MObject AngleSpringNode::aTargetRotateY;
+MObject AngleSpringNode::aTargetRotateZ;
+MObject AngleSpringNode::aTargetArray;
+
+MObject AngleSpringNode::aOutput;
+MObject AngleSpringNode::aOutputRotate;
+MObject AngleSpringNode::aOutputRotateX;
+MObject AngleSpringNode::aOutputRotateY;
+MObject AngleSpringNode::aOutputRotateZ;
+MObject AngleSpringNode::aOutputArray;
+
+// Layout of the state arrays: the single angle, the rotate compound, and then
+// the elements of the target array.
+const unsigned ROTATE_OFFSET = 1;
+const unsigned ARRAY_OFFSET = 4;
+
+AngleSpringNode::AngleSpringNode() : 
+    initialized_(false), 
+    lastSeconds_(0.0), 
+    lastStep_(0),
+    lastSubstepRate_(0)
+{
+}
+
+// Returns the index of the last fixed step that ends at or before the given
+// time. Rounds to the nearest step so that frame times which land on a step 
+// boundary are not lost to floating point error.
+static long long stepIndex(double seconds, int substepRate)
+{
+    return (long long) floor(seconds * (double) substepRate + 0.5);
+}
+
+void* AngleSpringNode::creator()
+{
+    return new AngleSpringNode();
+}
+
+MStatus AngleSpringNode::initialize()
+{
+    MStatus status;
+
+    MFnNumericAttribute n;
+    MFnUnitAttribute u;
+
+    aTime = u.create("time", "tm", MFnUnitAttribute::kTime, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+
+    aStartFrame = n.create("startFrame", "sf", MFnNumericData::kDouble, 1.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+
+    aStiffness = n.create("stiffness", "stf", MFnNumericData::kDouble, 100.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+    n.setMin(0.0);
+    n.setSoftMax(1000.0);
+
+    aDamping = n.create("damping", "dmp", MFnNumericData::kDouble, 1.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+    n.setMin(0.0);
+    n.setSoftMax(2.0);
+
+    aSubstepRate = n.create("substepRate", "ssr", MFnNumericData::kInt, 240, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+    n.setMin(1);
+    n.setSoftMax(1000);
+
+    aParallelThreshold = n.create("parallelThreshold", "pth", MFnNumericData::kInt, DEFAULT_PARALLEL_THRESHOLD, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+    n.setKeyable(false);
+    n.setMin(0);
+
+    aTarget = u.create("target", "t", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+
+    aTargetRotateX = u.create("targetRotateX", "trx", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    aTargetRotateY = u.create("targetRotateY", "try", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    aTargetRotateZ = u.create("targetRotateZ", "trz", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+
+    aTargetRotate = n.create("targetRotate", "tr", aTargetRotateX, aTargetRotateY, aTargetRotateZ, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(n);
+
+    aTargetArray = u.create("targetArray", "ta", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_INPUT_ATTR(u);
+    u.setArray(true);
+
+    aOutput = u.create("output", "o", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_OUTPUT_ATTR(u);
+
+    aOutputRotateX = u.create("outputRotateX", "orx", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    aOutputRotateY = u.create("outputRotateY", "ory", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    aOutputRotateZ = u.create("outputRotateZ", "orz", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+
+    aOutputRotate = n.create("outputRotate", "or", aOutputRotateX, aOutputRotateY, aOutputRotateZ, &status);
+    __CHECK_STATUS(status);
+    MAKE_OUTPUT_ATTR(n);
+
+    aOutputArray = u.create("outputArray", "oa", MFnUnitAttribute::kAngle, 0.0, &status);
+    __CHECK_STATUS(status);
+    MAKE_OUTPUT_ATTR(u);
+    u.setArray(true);
+    u.setUsesArrayDataBuilder(true);
+
+    addAttribute(aTime);
+    addAttribute(aStartFrame);
+    addAttribute(aStiffness);
+    addAttribute(aDamping);
+    addAttribute(aSubstepRate);
+    addAttribute(aParallelThreshold);
+    addAttribute(aTarget);
+    addAttribute(aTargetRotate);
+    addAttribute(aTargetArray);
+    addAttribute(aOutput);
+    addAttribute(aOutputRotate);
+    addAttribute(aOutputArray);
+
+    // Every output is written by the same compute, so every input affects all
+    // of them and the springs always advance together.
+    MObject inputs[] = { 
+        aTime, aStartFrame, aStiffness, aDamping, aSubstepRate, aParallelThreshold,
+        aTarget, aTargetRotate, aTargetArray
+    };
+
+    for (unsigned i = 0; i < sizeof(inputs) / sizeof(MObject); i++)
+    {
+        attributeAffects(inputs[i], aOutput);
+        attributeAffects(inputs[i], aOutputRotate);
+        attributeAffects(inputs[i], aOutputArray);
+    }
+
+    return MS::kSuccess;
+}
+
+void AngleSpringNode::reset(double seconds, int substepRate)
+{
+    positions_ = targets_;
+    velocities_.assign(targets_.size(), 0.0);
+    stateIndices_ = arrayIndices_;
+
+    lastSeconds_ = seconds;
+    lastStep_ = stepIndex(seconds, substepRate);
+    lastSubstepRate_ = substepRate;
+    initialized_ = true;
+}
+
+// Copies the spring state onto the current targets. Target array springs are
+// matched by logical index; springs that are new since the last compute start
+// at rest on their target.
+void AngleSpringNode::remapState(std::vector<double>& positions, std::vector<double>& velocities) const
+{
+    positions = targets_;
+    velocities.assign(targets_.size(), 0.0);
+
+    if (!initialized_)
+    {
+        return;
+    }
+
+    for (unsigned i = 0; i < ARRAY_OFFSET; i++)
+    {
+        positions[i] = positions_[i];
+        velocities[i] = velocities_[i];
+    }
+
+    for (unsigned i = 0; i < arrayIndices_.size(); i++)
+    {
+        std::vector<unsigned>::const_iterator found = std::lower_bound(
+            stateIndices_.begin(), 
+            stateIndices_.end(), 
+            arrayIndices_[i]
+        );
+
+        if (found != stateIndices_.end() && *found == arrayIndices_[i])
+        {
+            size_t j = ARRAY_OFFSET + (found - stateIndices_.begin());
+
+            positions[ARRAY_OFFSET + i] = positions_[j];
+            velocities[ARRAY_OFFSET + i] = velocities_[j];
+        }
+    }
+}
+
+struct IntegrateData
+{
+    const double*   targets;
+    double*         positions;
+    double*         velocities;
+    unsigned        steps;
+    double          h;
+    double          k;
+    double          scale;
+};
+
+static void integrateRange(void* data, unsigned begin, unsigned end)
+{
+    IntegrateData* d = (IntegrateData*) data;
+
+    for (unsigned i = begin; i < end; i++)
+    {
+        double target = d->targets[i];
+        double x = d->positions[i];
+        double v = d->velocities[i];
+
+        for (unsigned s = 0; s < d->steps; s++)
+        {
+            v = (v + d->h * d->k * (target - x)) * d->scale;
+            x += d->h * v;
+        }
+
+        d->positions[i] = x;
+        d->velocities[i] = v;
+    }
+}
+
+void AngleSpringNode::integrate(double seconds, double stiffness, double damping, int substepRate, unsigned parallelThreshold)
+{
+    // A new substep rate changes the step grid, so the last step is 
+    // re-measured on the new grid.
+    if (substepRate != lastSubstepRate_)
+    {
+        lastStep_ = stepIndex(lastSeconds_, substepRate);
+        lastSubstepRate_ = substepRate;
+    }
+
+    long long step = stepIndex(seconds, substepRate);
+    long long numSteps = step - lastStep_;
+
+    lastSeconds_ = seconds;
+    lastStep_ = step;
+
+    if (numSteps < 1)
+    {
+        return;
+    }
+
+    double stepSize = 1.0 / (double) substepRate;
+
+    // Implicit Euler step for x'' = k (target - x) - c x', solved for the new
+    // velocity: v' = (v + h k (target - x)) / (1 + h c + h^2 k).
+    double c = 2.0 * damping * sqrt(stiffness);
+
+    IntegrateData data;
+    data.targets = targets_.data();
+    data.positions = positions_.data();
+    data.velocities = velocities_.data();
+    data.steps = (unsigned) numSteps;
+    data.h = stepSize;
+    data.k = stiffness;
+    data.scale = 1.0 / (1.0 + stepSize * c + stepSize * stepSize * stiffness);
+
+    unsigned count = (unsigned) targets_.size();
+
+    parallelFor(count, 256, count >= parallelThreshold, integrateRange, &data);
+}
+
+MStatus AngleSpringNode::compute(const MPlug& plug, MDataBlock& data)
+{
+    MPlug outputPlug = plug;
+
+    if (outputPlug.isElement()) outputPlug = outputPlug.array();
+    if (outputPlug.isChild()) outputPlug = outputPlug.parent();
+
+    if (outputPlug != aOutput && outputPlug != aOutputRotate && outputPlug != aOutputArray)
+    {
+        return MS::kUnknownParameter;
+    }
+
+    MStatus status;
+
+    MTime time = data.inputValue(aTime).asTime();
+    double startFrame = data.inputValue(aStartFrame).asDouble();
+    double stiffness = data.inputValue(aStiffness).asDouble();
+    double damping = data.inputValue(aDamping).asDouble();
+    int substepRate = data.inputValue(aSubstepRate).asInt();
+    int parallelThreshold = data.inputValue(aParallelThreshold).asInt();
+
+    MDataHandle targetRotateHandle = data.inputValue(aTargetRotate);
+    MArrayDataHandle targetArrayHandle = data.inputArrayValue(aTargetArray);
+
+    unsigned numElements = targetArrayHandle.elementCount();
+    unsigned numTargets = ARRAY_OFFSET + numElements;
+
+    targets_.resize(numTargets);
+    arrayIndices_.resize(numElements);
+
+    targets_[0] = data.inputValue(aTarget).asAngle().asDegrees();
+    targets_[ROTATE_OFFSET + 0] = targetRotateHandle.child(aTargetRotateX).asAngle().asDegrees();
+    targets_[ROTATE_OFFSET + 1] = targetRotateHandle.child(aTargetRotateY).asAngle().asDegrees();
+    targets_[ROTATE_OFFSET + 2] = targetRotateHandle.child(aTargetRotateZ).asAngle().asDegrees();
+
+    for (unsigned i = 0; i < numElements; i++)
+    {
+        targets_[ARRAY_OFFSET + i] = targetArrayHandle.inputValue().asAngle().asDegrees();
+        arrayIndices_[i] = targetArrayHandle.elementIndex();
+        targetArrayHandle.next();
+    }
+
+    double frame = time.as(MTime::uiUnit());
+    double seconds = time.as(MTime::kSeconds);
+
+    substepRate = std::max(substepRate, 1);
+
+    // The springs depend on their history, so only the normal context owns 
+    // the state; other contexts see it as it is without advancing it.
+    if (!data.context().isNormal())
+    {
+        this->remapState(scratchPositions_, scratchVelocities_);
+    }
+    else if (!initialized_ || frame <= startFrame || seconds < lastSeconds_)
+    {
+        this->reset(seconds, substepRate);
+        scratchPositions_ = positions_;
+    } 
+    else 
+    {
+        this->remapState(scratchPositions_, scratchVelocities_);
+
+        positions_.swap(scratchPositions_);
+        velocities_.swap(scratchVelocities_);
+        stateIndices_ = arrayIndices_;
+
+        this->integrate(seconds, stiffness, damping, substepRate, (unsigned) parallelThreshold);
+        scratchPositions_ = positions_;
+    }
+
+    const std::vector<double>& results = scratchPositions_;
+
+    MDataHandle outputHandle = data.outputValue(aOutput);
+    outputHandle.setMAngle(MAngle(results[0], MAngle::kDegrees));
+    outputHandle.setClean();
+
+    MDataHandle outputRotateHandle = data.outputValue(aOutputRotate);
+    outputRotateHandle.child(aOutputRotateX).setMAngle(MAngle(results[ROTATE_OFFSET + 0], MAngle::kDegrees));
+    outputRotateHandle.child(aOutputRotateY).setMAngle(MAngle(results[ROTATE_OFFSET + 1], MAngle::kDegrees));
+    outputRotateHandle.child(aOutputRotateZ).setMAngle(MAngle(results[ROTATE_OFFSET + 2], MAngle::kDegrees));
+    outputRotateHandle.setClean();
+
+    MArrayDataHandle outputArrayHandle = data.outputArrayValue(aOutputArray);
+    MArrayDataBuilder builder(&data, aOutputArray, numElements, &status);
+    __CHECK_STATUS(status);
+
+    for (unsigned i = 0; i < numElements; i++)
+    {
+        MDataHandle output = builder.addElement(arrayIndices_[i]);
+        output.setMAngle(MAngle(results[ARRAY_OFFSET + i], MAngle::kDegrees));
+    }
+
+    outputArrayHandle.set(builder);
+    outputArrayHandle.setAllClean();
+
+    return MS::kSuccess;
+}
\ No newline at end of file
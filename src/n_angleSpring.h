@@ -0,0 +1,68 @@
+#ifndef N_ANGLE_SPRING_H
+#define N_ANGLE_SPRING_H
+
+#include <vector>
+
+#include <maya/MDataBlock.h>
+#include <maya/MPlug.h>
+#include <maya/MPxNode.h>
+#include <maya/MString.h>
+#include <maya/MTypeId.h>
+
+class AngleSpringNode : public MPxNode
+{
+public:
+                            AngleSpringNode();
+
+    virtual MStatus         compute(const MPlug& plug, MDataBlock& data);
+    static  void*           creator();
+    static  MStatus         initialize();
+
+public:
+    static MTypeId          kNODE_ID;
+    static MString          kNODE_NAME;
+
+    static MObject          aTime;
+    static MObject          aStartFrame;
+    static MObject          aStiffness;
+    static MObject          aDamping;
+    static MObject          aSubstepRate;
+    static MObject          aParallelThreshold;
+
+    static MObject          aTarget;
+    static MObject          aTargetRotate;
+    static MObject          aTargetRotateX;
+    static MObject          aTargetRotateY;
+    static MObject          aTargetRotateZ;
+    static MObject          aTargetArray;
+
+    static MObject          aOutput;
+    static MObject          aOutputRotate;
+    static MObject          aOutputRotateX;
+    static MObject          aOutputRotateY;
+    static MObject          aOutputRotateZ;
+    static MObject          aOutputArray;
+
+private:
+    void                    reset(double seconds, int substepRate);
+    void                    remapState(std::vector<double>& positions, std::vector<double>& velocities) const;
+    void                    integrate(double seconds, double stiffness, double damping, int substepRate, unsigned parallelThreshold);
+
+private:
+    bool                    initialized_;
+    double                  lastSeconds_;
+    long long               lastStep_;
+    int                     lastSubstepRate_;
+
+    std::vector<double>     targets_;
+    std::vector<unsigned>   arrayIndices_;
+
+    std::vector<double>     positions_;
+    std::vector<double>     velocities_;
+    std::vector<unsigned>   stateIndices_;
+
+    std::vector<double>     scratchPositions_;
+    std::vector<double>     scratchVelocities_;
+};
+
+#endif
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef N_NODE_H
 #define N_NODE_H
 
+#include <math.h>
+
 #define MAKE_INPUT_ATTR(fnAttr) \
     fnAttr.setKeyable(true); \
     fnAttr.setChannelBox(true); \
@@ -19,4 +21,10 @@
     #define __CHECK_STATUS(status) ;
 #endif
 
+// Wraps an angle (in degrees) into the range [-180, 180).
+inline double wrapAngle(double degrees)
+{
+    return degrees - 360.0 * floor((degrees + 180.0) / 360.0);
+}
+
 #endif
\ No newline at end of file
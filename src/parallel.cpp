@@ -0,0 +1,97 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#define NOMINMAX
+
+#include "parallel.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <maya/MStatus.h>
+#include <maya/MThreadPool.h>
+#include <maya/MThreadUtils.h>
+
+struct ParallelForTask
+{
+    RangeFunc   func;
+    void*       data;
+    unsigned    begin;
+    unsigned    end;
+};
+
+static bool isThreadPoolInitialized = false;
+
+MStatus initializeThreadPool()
+{
+    MStatus status = MThreadPool::init();
+    isThreadPoolInitialized = status == MS::kSuccess;
+
+    return status;
+}
+
+void releaseThreadPool()
+{
+    if (isThreadPoolInitialized)
+    {
+        MThreadPool::release();
+        isThreadPoolInitialized = false;
+    }
+}
+
+static MThreadRetVal runTask(void* data)
+{
+    ParallelForTask* task = (ParallelForTask*) data;
+    task->func(task->data, task->begin, task->end);
+
+    return (MThreadRetVal) 0;
+}
+
+static void runRegion(void* data, MThreadRootTask* root)
+{
+    std::vector<ParallelForTask>& tasks = *(std::vector<ParallelForTask>*) data;
+
+    for (size_t i = 0; i < tasks.size(); i++)
+    {
+        MThreadPool::createTask(runTask, (void*) &tasks[i], root);
+    }
+
+    MThreadPool::executeAndJoin(root);
+}
+
+void parallelFor(unsigned count, unsigned grainSize, bool isParallel, RangeFunc func, void* data)
+{
+    grainSize = std::max(grainSize, 1u);
+
+    unsigned numGrains = (count + grainSize - 1) / grainSize;
+    unsigned numThreads = (unsigned) std::max(MThreadUtils::getNumThreads(), 1);
+    unsigned numTasks = std::min(numGrains, numThreads);
+
+    if (!isParallel || !isThreadPoolInitialized || numTasks < 2)
+    {
+        func(data, 0, count);
+        return;
+    }
+
+    std::vector<ParallelForTask> tasks(numTasks);
+
+    for (unsigned i = 0; i < numTasks; i++)
+    {
+        unsigned long long firstGrain = (unsigned long long) numGrains * i / numTasks;
+        unsigned long long lastGrain = (unsigned long long) numGrains * (i + 1) / numTasks;
+
+        tasks[i].func = func;
+        tasks[i].data = data;
+        tasks[i].begin = (unsigned) std::min(firstGrain * grainSize, (unsigned long long) count);
+        tasks[i].end = (unsigned) std::min(lastGrain * grainSize, (unsigned long long) count);
+    }
+
+    MStatus status = MThreadPool::newParallelRegion(runRegion, (void*) &tasks);
+
+    if (status != MS::kSuccess)
+    {
+        func(data, 0, count);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef N_PARALLEL_H
+#define N_PARALLEL_H
+
+//-----------------------------------------------------------------------------
+//  Intra-compute parallelism for nodes with very large array inputs.
+//
+//  Work is split into fixed-size grains that are handed to Maya's thread 
+//  pool. Since Maya 2016 the pool is shared with the Evaluation Manager, so
+//  running these tasks from inside a compute does not oversubscribe the 
+//  machine under parallel evaluation.
+//-----------------------------------------------------------------------------
+
+#include <maya/MStatus.h>
+
+// Default number of input values above which a node splits its work across
+// threads; each node exposes this as its parallelThreshold attribute.
+const int DEFAULT_PARALLEL_THRESHOLD = 16384;
+
+typedef void (*RangeFunc)(void* data, unsigned begin, unsigned end);
+
+MStatus initializeThreadPool();
+void    releaseThreadPool();
+
+// Calls func over [0, count) in contiguous ranges of whole grains. The 
+// ranges run on the thread pool when isParallel is true and there is more
+// than one grain, otherwise func is called once with the whole range.
+void    parallelFor(unsigned count, unsigned grainSize, bool isParallel, RangeFunc func, void* data);
+
+#endif
\ No newline at end of file
@@ -34,11 +34,20 @@ These nodes operation on doubleAngle values as inputs and outputs, eliminating
 the need for a unit conversion node in most cases.
 */
 
+#include "c_angularNodesBenchmark.h"
+#include "c_bakeAngleCache.h"
+#include "c_buildAngularNetwork.h"
 #include "n_angleBinaryOp.h"
+#include "n_angleBlend.h"
+#include "n_angleCache.h"
 #include "n_angleMultiOp.h"
+#include "n_anglePoseInterpolator.h"
 #include "n_angleScalarOp.h"
+#include "n_angleSegmentOp.h"
+#include "n_angleSpring.h"
 #include "n_angleUnaryOp.h"
 #include "n_clampAngle.h"
+#include "parallel.h"
 
 #include <maya/MFnPlugin.h>
 #include <maya/MTypeId.h>
@@ -53,12 +62,26 @@ MString AngleBinaryOpNode::kNODE_NAME =     "angleBinaryOp";
 MString AngleMultiOpNode::kNODE_NAME =      "angleMultiOp";
 MString AngleScalarOpNode::kNODE_NAME =     "angleScalarOp";
 MString AngleUnaryOpNode::kNODE_NAME =      "angleUnaryOp";
+MString AngleSegmentOpNode::kNODE_NAME =    "angleSegmentOp";
+MString AngleSpringNode::kNODE_NAME =       "angleSpring";
+MString AngleBlendNode::kNODE_NAME =        "angleBlend";
+MString AnglePoseInterpolatorNode::kNODE_NAME = "anglePoseInterpolator";
+MString AngleCacheNode::kNODE_NAME =        "angleCache";
 
 MTypeId AngleBinaryOpNode::kNODE_ID =       0x00126b12;
 MTypeId AngleMultiOpNode::kNODE_ID =        0x00126b13;
 MTypeId AngleScalarOpNode::kNODE_ID =       0x00126b14;
 MTypeId AngleUnaryOpNode::kNODE_ID =        0x00126b15;
 MTypeId ClampAngleNode::kNODE_ID =          0x00126b16;
+MTypeId AngleSegmentOpNode::kNODE_ID =      0x00126b17;
+MTypeId AngleSpringNode::kNODE_ID =         0x00126b18;
+MTypeId AngleBlendNode::kNODE_ID =          0x00126b19;
+MTypeId AnglePoseInterpolatorNode::kNODE_ID = 0x00126b1a;
+MTypeId AngleCacheNode::kNODE_ID =          0x00126b1b;
+
+MString AngularNodesBenchmarkCommand::kCOMMAND_NAME = "angularNodesBenchmark";
+MString BuildAngularNetworkCommand::kCOMMAND_NAME = "buildAngularNetwork";
+MString BakeAngleCacheCommand::kCOMMAND_NAME = "bakeAngleCache";
 
 #define REGISTER_NODE(NODE)                    \
     status = fnPlugin.registerNode(            \
@@ -75,16 +98,42 @@ MTypeId ClampAngleNode::kNODE_ID =          0x00126b16;
     );                                         \
     CHECK_MSTATUS_AND_RETURN_IT(status);       \
 
+#define REGISTER_COMMAND(COMMAND)              \
+    status = fnPlugin.registerCommand(         \
+        COMMAND::kCOMMAND_NAME,                \
+        COMMAND::creator,                      \
+        COMMAND::newSyntax                     \
+    );                                         \
+    CHECK_MSTATUS_AND_RETURN_IT(status);       \
+
+#define DEREGISTER_COMMAND(COMMAND)            \
+    status = fnPlugin.deregisterCommand(       \
+        COMMAND::kCOMMAND_NAME                 \
+    );                                         \
+    CHECK_MSTATUS_AND_RETURN_IT(status);       \
+
 MStatus initializePlugin(MObject obj)
 {
     MStatus status;
     MFnPlugin fnPlugin(obj, kAUTHOR, kVERSION, kREQUIRED_API_VERSION);
 
+    // Without the thread pool the nodes fall back to single-threaded computes.
+    initializeThreadPool();
+
     REGISTER_NODE(AngleMultiOpNode);
     REGISTER_NODE(AngleBinaryOpNode);
     REGISTER_NODE(AngleScalarOpNode);
     REGISTER_NODE(AngleUnaryOpNode);
     REGISTER_NODE(ClampAngleNode);
+    REGISTER_NODE(AngleSegmentOpNode);
+    REGISTER_NODE(AngleSpringNode);
+    REGISTER_NODE(AngleBlendNode);
+    REGISTER_NODE(AnglePoseInterpolatorNode);
+    REGISTER_NODE(AngleCacheNode);
+
+    REGISTER_COMMAND(AngularNodesBenchmarkCommand);
+    REGISTER_COMMAND(BuildAngularNetworkCommand);
+    REGISTER_COMMAND(BakeAngleCacheCommand);
 
     return MS::kSuccess;
 }
@@ -99,6 +148,17 @@ MStatus uninitializePlugin(MObject obj)
     DEREGISTER_NODE(AngleScalarOpNode);
     DEREGISTER_NODE(AngleUnaryOpNode);
     DEREGISTER_NODE(ClampAngleNode);
+    DEREGISTER_NODE(AngleSegmentOpNode);
+    DEREGISTER_NODE(AngleSpringNode);
+    DEREGISTER_NODE(AngleBlendNode);
+    DEREGISTER_NODE(AnglePoseInterpolatorNode);
+    DEREGISTER_NODE(AngleCacheNode);
+
+    DEREGISTER_COMMAND(AngularNodesBenchmarkCommand);
+    DEREGISTER_COMMAND(BuildAngularNetworkCommand);
+    DEREGISTER_COMMAND(BakeAngleCacheCommand);
+
+    releaseThreadPool();
 
     return MS::kSuccess;
 }
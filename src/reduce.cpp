@@ -0,0 +1,54 @@
+/**
+Copyright (c) 2016 Ryan Porter - arrayNodes
+You may use, distribute, or modify this code under the terms of the MIT license.
+*/
+
+#include "reduce.h"
+#include "parallel.h"
+
+#include <vector>
+
+struct ReduceChunksData
+{
+    short           operation;
+    const double*   values;
+    unsigned        count;
+    double*         partials;
+};
+
+static void reduceChunks(void* data, unsigned begin, unsigned end)
+{
+    ReduceChunksData* d = (ReduceChunksData*) data;
+
+    for (unsigned c = begin; c < end; c++)
+    {
+        unsigned start = c * REDUCE_CHUNK_SIZE;
+        unsigned size = d->count - start < REDUCE_CHUNK_SIZE ? d->count - start : REDUCE_CHUNK_SIZE;
+
+        d->partials[c] = reduceAngles(d->operation, d->values + start, size);
+    }
+}
+
+double reduceAnglesChunked(short operation, const double* values, unsigned count, unsigned threshold)
+{
+    if (count <= REDUCE_CHUNK_SIZE)
+    {
+        return reduceAngles(operation, values, count);
+    }
+
+    unsigned numChunks = (count + REDUCE_CHUNK_SIZE - 1) / REDUCE_CHUNK_SIZE;
+    std::vector<double> partials(numChunks);
+
+    ReduceChunksData data;
+    data.operation = operation;
+    data.values = values;
+    data.count = count;
+    data.partials = partials.data();
+
+    parallelFor(numChunks, 1, count >= threshold, reduceChunks, &data);
+
+    // Each Difference partial is already the negated sum of its chunk.
+    short combine = operation == DIFF ? SUM : operation;
+
+    return reduceAngles(combine, partials.data(), numChunks);
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef N_REDUCE_H
+#define N_REDUCE_H
+
+//-----------------------------------------------------------------------------
+//  Reducing operations shared by the angleMultiOp and angleSegmentOp nodes.
+//
+//  The kernels work on a contiguous block of doubles with a single scalar 
+//  accumulator so that the compiler can vectorize the loops.
+//-----------------------------------------------------------------------------
+
+// Number of values reduced by each leaf of reduceAnglesChunked.
+const unsigned REDUCE_CHUNK_SIZE = 4096;
+
+const short NO_OP = 0;
+const short SUM = 1;
+const short DIFF = 2;
+const short PRODUCT = 3;
+const short MIN_ = 4;
+const short MAX_ = 5;
+
+inline double reduceAngles(short operation, const double* values, unsigned count)
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    double result = 0.0;
+
+    switch (operation)
+    {
+        case SUM:
+            for (unsigned i = 0; i < count; i++) result += values[i];
+            break;
+
+        case DIFF:
+            for (unsigned i = 0; i < count; i++) result -= values[i];
+            break;
+
+        case PRODUCT:
+            result = 1.0;
+            for (unsigned i = 0; i < count; i++) result *= values[i];
+            break;
+
+        case MIN_:
+            result = values[0];
+            for (unsigned i = 1; i < count; i++) result = values[i] < result ? values[i] : result;
+            break;
+
+        case MAX_:
+            result = values[0];
+            for (unsigned i = 1; i < count; i++) result = values[i] > result ? values[i] : result;
+            break;
+    }
+
+    return result;
+}
+
+// Reduces the values in fixed chunks of REDUCE_CHUNK_SIZE and then reduces
+// the chunk results in order. The reduction tree depends only on the number
+// of values, so the result is the same whether or not the chunks are spread
+// across threads; they are when count is at least threshold.
+double reduceAnglesChunked(short operation, const double* values, unsigned count, unsigned threshold);
+
+#endif
\ No newline at end of file